@@ -0,0 +1,79 @@
+// The balancing policies under lookup/insert/erase mixes. Each run fills a
+// map with count random keys from [0, 2 * count) and then draws operations
+// on keys from the same range, so the size stays roughly constant. The
+// final tree height and average depth are printed with each row.
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "bench_common.h"
+#include "s21_map.h"
+
+namespace {
+struct mix {
+  const char *name;
+  int lookups;
+  int inserts;
+};
+
+const mix kMixes[] = {{"90/5/5", 90, 5}, {"50/25/25", 50, 25},
+                      {"10/45/45", 10, 45}};
+
+template <typename Balance>
+void run(const char *policy, std::size_t count) {
+  std::printf("%s\n", policy);
+  int space = int(2 * count);
+  std::mt19937 gen(31);
+  std::uniform_int_distribution<int> keys(0, space - 1);
+  {
+    s21::map<int, int, std::less<int>, Balance> m;
+    bench::report("ascending insert", bench::nanosPer(count, [&] {
+                    for (int key = 0; key < int(count); ++key) {
+                      m.insert(key, key);
+                    }
+                  }));
+  }
+  for (const mix &ops : kMixes) {
+    s21::map<int, int, std::less<int>, Balance> m;
+    while (m.size() < count) {
+      int key = keys(gen);
+      m.insert(key, key);
+    }
+    std::size_t steps = 4 * count;
+    std::vector<std::pair<int, int>> plan(steps);
+    std::uniform_int_distribution<int> percent(0, 99);
+    for (std::pair<int, int> &step : plan) {
+      step = {percent(gen), keys(gen)};
+    }
+    double nanos = bench::nanosPer(steps, [&] {
+      std::size_t sum = 0;
+      for (const std::pair<int, int> &step : plan) {
+        if (step.first < ops.lookups) {
+          sum += m.get_or(step.second, 0);
+        } else if (step.first < ops.lookups + ops.inserts) {
+          sum += m.insert(step.second, step.second).second;
+        } else {
+          auto it = m.find(step.second);
+          if (it != m.end()) m.erase(it);
+        }
+      }
+      bench::keep(sum);
+    });
+    s21::tree_stats shape = m.stats();
+    char label[64];
+    std::snprintf(label, sizeof(label), "%s (height %zu, depth %.1f)",
+                  ops.name, shape.height, shape.average_depth);
+    bench::report(label, nanos);
+  }
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::size_t count = bench::countArg(argc, argv, 1000000);
+  std::printf("map<int, int>, %zu elements, lookup/insert/erase %%\n", count);
+  run<s21::avl_balance>("avl_balance", count);
+  run<s21::red_black_balance>("red_black_balance", count);
+  run<s21::weight_balance>("weight_balance", count);
+  return 0;
+}
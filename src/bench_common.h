@@ -0,0 +1,41 @@
+#ifndef S21_CONTAINERS_BENCH_COMMON_H
+#define S21_CONTAINERS_BENCH_COMMON_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Helpers shared by the bench_*.cc programs. They are built by `make bench`,
+// separately from the tests and with optimization on.
+namespace bench {
+// Element count from the first command line argument, or fallback.
+inline std::size_t countArg(int argc, char **argv, std::size_t fallback) {
+  if (argc < 2) return fallback;
+  std::size_t count = std::strtoull(argv[1], nullptr, 10);
+  return count > 0 ? count : fallback;
+}
+
+// Wall time of body() divided by ops, in nanoseconds.
+template <typename F>
+double nanosPer(std::size_t ops, F &&body) {
+  auto start = std::chrono::steady_clock::now();
+  body();
+  std::chrono::duration<double, std::nano> spent =
+      std::chrono::steady_clock::now() - start;
+  return spent.count() / double(ops);
+}
+
+inline void report(const std::string &name, double nanos) {
+  std::printf("  %-44s %10.1f ns/op\n", name.c_str(), nanos);
+}
+
+// Stores a result the optimizer must not discard.
+template <typename T>
+void keep(const T &value) {
+  static volatile std::size_t sink;
+  sink = sink + std::size_t(value);
+}
+}  // namespace bench
+
+#endif  // S21_CONTAINERS_BENCH_COMMON_H
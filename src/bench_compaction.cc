@@ -0,0 +1,69 @@
+// Iteration, lookup and teardown of a churned map before and after
+// compact(), in both node layouts. Churn replaces every element once in
+// random order after the initial fill, which scatters the nodes over the
+// heap.
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_common.h"
+#include "s21_map.h"
+
+namespace {
+using map_type = s21::map<int, int>;
+
+std::unique_ptr<map_type> churned(std::size_t count) {
+  std::mt19937 gen(36);
+  std::vector<int> keys(2 * count);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), gen);
+  auto m = std::make_unique<map_type>();
+  for (std::size_t i = 0; i < count; ++i) m->insert(keys[i], keys[i]);
+  std::vector<int> present(keys.begin(), keys.begin() + count);
+  std::shuffle(present.begin(), present.end(), gen);
+  for (std::size_t i = 0; i < count; ++i) {
+    m->erase(m->find(present[i]));
+    m->insert(keys[count + i], keys[count + i]);
+  }
+  return m;
+}
+
+void run(const std::string &label, std::unique_ptr<map_type> m,
+         const std::vector<int> &probes) {
+  std::printf("%s\n", label.c_str());
+  bench::report("iterate", bench::nanosPer(m->size(), [&] {
+                  std::size_t sum = 0;
+                  for (const auto &elem : *m) sum += elem.second;
+                  bench::keep(sum);
+                }));
+  bench::report("lookup", bench::nanosPer(probes.size(), [&] {
+                  std::size_t sum = 0;
+                  for (int key : probes) sum += m->at(key);
+                  bench::keep(sum);
+                }));
+  std::size_t size = m->size();
+  bench::report("destroy", bench::nanosPer(size, [&] { m.reset(); }));
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::size_t count = bench::countArg(argc, argv, 1000000);
+  std::printf("map<int, int>, %zu elements\n", count);
+  std::unique_ptr<map_type> m = churned(count);
+  std::vector<int> probes;
+  probes.reserve(count);
+  for (const auto &elem : *m) probes.push_back(elem.first);
+  std::shuffle(probes.begin(), probes.end(), std::mt19937(360));
+  run("after churn", std::move(m), probes);
+  m = churned(count);
+  m->compact(s21::node_layout::in_order);
+  run("compact(in_order)", std::move(m), probes);
+  m = churned(count);
+  m->compact(s21::node_layout::van_emde_boas);
+  run("compact(van_emde_boas)", std::move(m), probes);
+  return 0;
+}
@@ -0,0 +1,69 @@
+// map::at() under Zipf-distributed keys, with and without the lookup cache,
+// at several skews. Rank r is drawn with probability proportional to
+// 1 / r^s; ranks are mapped to keys through a random permutation so hot
+// keys are scattered over the tree.
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_common.h"
+#include "s21_map.h"
+
+namespace {
+std::vector<int> zipfKeys(const std::vector<int> &byRank, double skew,
+                          std::size_t draws, std::mt19937 &gen) {
+  std::vector<double> weight(byRank.size());
+  for (std::size_t r = 0; r < weight.size(); ++r) {
+    weight[r] = 1.0 / std::pow(double(r + 1), skew);
+  }
+  std::partial_sum(weight.begin(), weight.end(), weight.begin());
+  std::uniform_real_distribution<double> pick(0.0, weight.back());
+  std::vector<int> keys(draws);
+  for (int &key : keys) {
+    std::size_t rank =
+        std::lower_bound(weight.begin(), weight.end(), pick(gen)) -
+        weight.begin();
+    key = byRank[std::min(rank, byRank.size() - 1)];
+  }
+  return keys;
+}
+
+double lookups(s21::map<int, int> &m, const std::vector<int> &keys) {
+  return bench::nanosPer(keys.size(), [&] {
+    std::size_t sum = 0;
+    for (int key : keys) sum += m.at(key);
+    bench::keep(sum);
+  });
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::size_t count = bench::countArg(argc, argv, 1000000);
+  std::size_t draws = 4 * count;
+  std::mt19937 gen(30);
+  std::vector<int> byRank(count);
+  std::iota(byRank.begin(), byRank.end(), 0);
+  std::shuffle(byRank.begin(), byRank.end(), gen);
+  s21::map<int, int> m;
+  for (int key : byRank) m.insert(key, key);
+  std::printf("map::at, %zu elements, %zu Zipf lookups\n", count, draws);
+  for (double skew : {0.5, 0.8, 0.99, 1.2}) {
+    std::vector<int> keys = zipfKeys(byRank, skew, draws, gen);
+    char label[32];
+    std::snprintf(label, sizeof(label), "s = %.2f", skew);
+    m.disable_lookup_cache();
+    bench::report(std::string(label) + " no cache", lookups(m, keys));
+    m.enable_lookup_cache();
+    double nanos = lookups(m, keys);
+    s21::map<int, int>::cache_stats stats = m.lookup_cache_stats();
+    std::snprintf(label, sizeof(label), "s = %.2f cache, %.0f%% hits", skew,
+                  100.0 * double(stats.hits) /
+                      double(std::max<std::size_t>(stats.hits + stats.misses,
+                                                   1)));
+    bench::report(label, nanos);
+  }
+  return 0;
+}
@@ -0,0 +1,62 @@
+// Cost of looking up absent keys in a map: the non-throwing find(),
+// try_get() and contains() against at() caught as std::out_of_range. The
+// map holds the even keys and misses probe odd ones, so every descent goes
+// to the bottom of the tree. Hits are timed for reference.
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "bench_common.h"
+#include "s21_map.h"
+
+int main(int argc, char **argv) {
+  std::size_t count = bench::countArg(argc, argv, 1000000);
+  std::mt19937 gen(32);
+  std::vector<int> keys(count);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), gen);
+  s21::map<int, int> m;
+  for (int key : keys) m.insert(2 * key, key);
+  std::printf("map<int, int>, %zu elements, %zu lookups\n", count, count);
+  bench::report("hit at()", bench::nanosPer(count, [&] {
+                  std::size_t sum = 0;
+                  for (int key : keys) sum += m.at(2 * key);
+                  bench::keep(sum);
+                }));
+  bench::report("hit try_get()", bench::nanosPer(count, [&] {
+                  std::size_t sum = 0;
+                  for (int key : keys) sum += *m.try_get(2 * key);
+                  bench::keep(sum);
+                }));
+  bench::report("miss find()", bench::nanosPer(count, [&] {
+                  std::size_t found = 0;
+                  for (int key : keys) found += m.find(2 * key + 1) != m.end();
+                  bench::keep(found);
+                }));
+  bench::report("miss try_get()", bench::nanosPer(count, [&] {
+                  std::size_t found = 0;
+                  for (int key : keys) {
+                    found += m.try_get(2 * key + 1) != nullptr;
+                  }
+                  bench::keep(found);
+                }));
+  bench::report("miss contains()", bench::nanosPer(count, [&] {
+                  std::size_t found = 0;
+                  for (int key : keys) found += m.contains(2 * key + 1);
+                  bench::keep(found);
+                }));
+  bench::report("miss at() with catch", bench::nanosPer(count, [&] {
+                  std::size_t thrown = 0;
+                  for (int key : keys) {
+                    try {
+                      bench::keep(m.at(2 * key + 1));
+                    } catch (const std::out_of_range &) {
+                      ++thrown;
+                    }
+                  }
+                  bench::keep(thrown);
+                }));
+  return 0;
+}
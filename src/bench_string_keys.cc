@@ -0,0 +1,87 @@
+// Insertion and lookup in a set of string keys, s21::set against std::set.
+// Keys are either random or share their first 8 bytes, which the key prefix
+// stored in s21::set nodes cannot tell apart. Build with
+//   make bench BENCHFLAGS="-O2 -DS21_CONTAINERS_NO_KEY_PREFIX"
+// to time the plain node layout, and pass 10000000 for the full-size run.
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bench_common.h"
+#include "s21_set.h"
+
+namespace {
+std::vector<std::string> randomKeys(std::size_t count, std::mt19937 &gen) {
+  std::uniform_int_distribution<int> letters('a', 'z');
+  std::vector<std::string> keys(count, std::string(20, ' '));
+  for (std::string &key : keys) {
+    for (char &c : key) c = char(letters(gen));
+  }
+  return keys;
+}
+
+// Even numbers for the stored keys and odd ones for misses, so that misses
+// land between stored keys.
+std::vector<std::string> sharedPrefixKeys(std::size_t parity,
+                                          std::size_t count) {
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  char buffer[32];
+  for (std::size_t i = 0; i < count; ++i) {
+    std::snprintf(buffer, sizeof(buffer), "session:%012zu", 2 * i + parity);
+    keys.emplace_back(buffer);
+  }
+  return keys;
+}
+
+template <typename Set>
+void run(const std::string &label, const std::vector<std::string> &keys,
+         const std::vector<std::string> &hits,
+         const std::vector<std::string> &misses) {
+  Set s;
+  bench::report(label + " insert", bench::nanosPer(keys.size(), [&] {
+                  for (const std::string &key : keys) s.insert(key);
+                }));
+  bench::report(label + " hit", bench::nanosPer(hits.size(), [&] {
+                  std::size_t found = 0;
+                  for (const std::string &key : hits) {
+                    found += s.find(key) != s.end();
+                  }
+                  bench::keep(found);
+                }));
+  bench::report(label + " miss", bench::nanosPer(misses.size(), [&] {
+                  std::size_t found = 0;
+                  for (const std::string &key : misses) {
+                    found += s.find(key) != s.end();
+                  }
+                  bench::keep(found);
+                }));
+}
+
+void runBoth(const std::string &label, const std::vector<std::string> &keys,
+             const std::vector<std::string> &misses, std::mt19937 &gen) {
+  std::vector<std::string> hits = keys;
+  std::shuffle(hits.begin(), hits.end(), gen);
+  std::printf("%s keys\n", label.c_str());
+  run<s21::set<std::string>>("s21::set", keys, hits, misses);
+  run<std::set<std::string>>("std::set", keys, hits, misses);
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::size_t count = bench::countArg(argc, argv, 1000000);
+  std::mt19937 gen(27);
+  std::printf("string keys, %zu elements\n", count);
+  std::vector<std::string> keys = randomKeys(count, gen);
+  std::vector<std::string> misses = randomKeys(count, gen);
+  runBoth("random", keys, misses, gen);
+  keys = sharedPrefixKeys(0, count);
+  std::shuffle(keys.begin(), keys.end(), gen);
+  misses = sharedPrefixKeys(1, count);
+  std::shuffle(misses.begin(), misses.end(), gen);
+  runBoth("shared prefix", keys, misses, gen);
+  return 0;
+}
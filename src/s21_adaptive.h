@@ -0,0 +1,602 @@
+#ifndef S21_CONTAINERS_ADAPTIVE_H
+#define S21_CONTAINERS_ADAPTIVE_H
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "s21_binary_tree.h"
+#include "s21_small_buffer.h"
+#include "s21_vector.h"
+
+namespace s21 {
+// Storage an adaptive container currently uses.
+enum class adaptive_layout { inline_array, sorted_vector, tree };
+
+// When an adaptive container changes layout. A full inline array becomes
+// a sorted vector. A sorted vector becomes a tree once it holds more than
+// sorted_max elements, or once it holds at least write_heavy_min elements
+// and has seen at least write_heavy_min writes, more writes than reads,
+// since its last layout change. Erases move a tree back to a sorted vector
+// when the size drops to sorted_max / shrink_ratio and reads have kept up
+// with writes, and a sorted vector back to the inline array at half the
+// inline capacity.
+struct adaptive_thresholds {
+  std::size_t sorted_max = 1024;
+  std::size_t write_heavy_min = 128;
+  std::size_t shrink_ratio = 4;
+};
+
+// Common part of adaptive_set and adaptive_map: elements live in an
+// unsorted inline array while there are at most InlineCapacity of them,
+// then in a sorted s21::vector, then in a BinaryTree. begin() sorts the
+// inline array in place, and any insert or erase may change the layout;
+// both invalidate all iterators.
+template <typename Key, typename Value, typename Compare, typename Balance,
+          std::size_t InlineCapacity>
+class AdaptiveTable {
+ public:
+  using key_type = Key;
+  using value_type = Value;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using size_type = std::size_t;
+  using key_compare = Compare;
+  using tree_type = BinaryTree<Key, Value, Compare, Balance>;
+  using Node = typename tree_type::Node;
+  using update_type = batch_update<value_type>;
+
+  static constexpr bool kIsSet = std::is_same<Key, Value>::value;
+
+  template <bool isConst>
+  class adaptiveIterator {
+   public:
+    using reference =
+        typename std::conditional<isConst, const Value &, Value &>::type;
+    using pointer =
+        typename std::conditional<isConst, const Value *, Value *>::type;
+
+    adaptiveIterator() = default;
+
+    // A map iterator converts to a const_iterator.
+    template <bool wasConst, typename = std::enable_if_t<isConst && !wasConst>>
+    adaptiveIterator(const adaptiveIterator<wasConst> &other) noexcept
+        : element(other.element), node(other.node), tree(other.tree) {}
+
+    reference operator*() const {
+      return tree != nullptr ? node->data : *element;
+    }
+
+    pointer operator->() const { return &**this; }
+
+    adaptiveIterator &operator++() {
+      if (tree != nullptr) {
+        node = node->moveForward();
+      } else {
+        ++element;
+      }
+      return *this;
+    }
+
+    adaptiveIterator &operator--() {
+      if (tree == nullptr) {
+        --element;
+      } else {
+        node = node != nullptr ? node->moveBack() : tree->getRoot()->getMax();
+      }
+      return *this;
+    }
+
+    bool operator==(const adaptiveIterator &other) const noexcept {
+      return element == other.element && node == other.node;
+    }
+
+    bool operator!=(const adaptiveIterator &other) const noexcept {
+      return !(*this == other);
+    }
+
+   private:
+    friend class AdaptiveTable;
+    template <bool>
+    friend class adaptiveIterator;
+
+    explicit adaptiveIterator(Value *element_) : element(element_) {}
+    adaptiveIterator(Node *node_, const tree_type *tree_)
+        : node(node_), tree(tree_) {}
+
+    Value *element = nullptr;
+    Node *node = nullptr;
+    const tree_type *tree = nullptr;
+  };
+
+  using iterator = adaptiveIterator<kIsSet>;
+  using const_iterator = adaptiveIterator<true>;
+
+  AdaptiveTable() = default;
+
+  explicit AdaptiveTable(const Compare &comp_) : comp(comp_) {}
+
+  AdaptiveTable(std::initializer_list<value_type> const &items,
+                const Compare &comp_ = Compare())
+      : comp(comp_) {
+    for (const auto &item : items) insert(item);
+  }
+
+  AdaptiveTable(const AdaptiveTable &other)
+      : layout_(other.layout_),
+        small(other.small),
+        smallSorted(other.smallSorted),
+        tree(other.tree ? new tree_type(*other.tree) : nullptr),
+        limits(other.limits),
+        comp(other.comp) {
+    sorted.reserve(other.sorted.size());
+    for (size_type i = 0; i < other.sorted.size(); ++i) {
+      sorted.push_back(other.sorted.data()[i]);
+    }
+  }
+
+  AdaptiveTable(AdaptiveTable &&other)
+      : layout_(std::exchange(other.layout_, adaptive_layout::inline_array)),
+        small(std::move(other.small)),
+        smallSorted(std::exchange(other.smallSorted, true)),
+        sorted(std::move(other.sorted)),
+        tree(std::exchange(other.tree, nullptr)),
+        limits(other.limits),
+        reads(std::exchange(other.reads, 0)),
+        writes(std::exchange(other.writes, 0)),
+        comp(other.comp) {}
+
+  AdaptiveTable &operator=(const AdaptiveTable &other) {
+    if (this != &other) {
+      AdaptiveTable copy(other);
+      swap(copy);
+    }
+    return *this;
+  }
+
+  AdaptiveTable &operator=(AdaptiveTable &&other) {
+    if (this != &other) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  ~AdaptiveTable() { delete tree; }
+
+  iterator begin() {
+    if (layout_ == adaptive_layout::tree) {
+      return iterator(tree->minNode(), tree);
+    }
+    return iterator(contiguousBegin());
+  }
+
+  iterator end() {
+    if (layout_ == adaptive_layout::tree) return iterator(nullptr, tree);
+    if (layout_ == adaptive_layout::sorted_vector) {
+      return iterator(sorted.data() + sorted.size());
+    }
+    return iterator(small.end());
+  }
+
+  const_iterator cbegin() const {
+    return const_cast<AdaptiveTable *>(this)->begin();
+  }
+
+  const_iterator cend() const {
+    return const_cast<AdaptiveTable *>(this)->end();
+  }
+
+  bool empty() const noexcept { return size() == 0; }
+
+  size_type size() const noexcept {
+    switch (layout_) {
+      case adaptive_layout::inline_array:
+        return small.size();
+      case adaptive_layout::sorted_vector:
+        return sorted.size();
+      default:
+        return tree->size();
+    }
+  }
+
+  size_type max_size() const noexcept {
+    return (std::numeric_limits<size_type>::max() / 2) / sizeof(Node);
+  }
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return emplaceKey(keyOf(value), [&] { return value; });
+  }
+
+  void erase(iterator pos) {
+    ++writes;
+    if (layout_ == adaptive_layout::inline_array) {
+      small.erase(pos.element - small.begin());
+    } else if (layout_ == adaptive_layout::sorted_vector) {
+      Value *first = sorted.data();
+      std::move(pos.element + 1, first + sorted.size(), pos.element);
+      sorted.pop_back();
+      shrink();
+    } else {
+      tree->erase(typename tree_type::iterator(pos.node, tree->getRoot()));
+      shrink();
+    }
+  }
+
+  // Removes all elements matching pred in one pass and returns how many
+  // were removed.
+  template <typename Pred>
+  size_type erase_if(Pred pred) {
+    size_type before = size();
+    if (layout_ == adaptive_layout::inline_array) {
+      for (size_type i = small.size(); i-- > 0;) {
+        if (pred(static_cast<const Value &>(small[i]))) small.erase(i);
+      }
+    } else if (layout_ == adaptive_layout::sorted_vector) {
+      Value *first = sorted.data();
+      size_type kept = std::remove_if(first, first + sorted.size(),
+                                      [&](const Value &value) {
+                                        return pred(value);
+                                      }) -
+                       first;
+      while (sorted.size() > kept) sorted.pop_back();
+    } else {
+      tree->eraseIf(pred);
+    }
+    size_type removed = before - size();
+    writes += removed;
+    if (removed != 0) shrink();
+    return removed;
+  }
+
+  // Applies a batch of inserts and erases. A later update of the same key
+  // overrides an earlier one; an insert of a present key overwrites the
+  // element. A tree takes the whole batch in one sorted merge.
+  void apply_batch(std::vector<update_type> updates) {
+    if (layout_ == adaptive_layout::tree) {
+      writes += updates.size();
+      tree->applyBatch(std::move(updates));
+      shrink();
+      return;
+    }
+    for (update_type &update : updates) {
+      const Key &key = keyOf(update.value);
+      if (update.op == batch_op::insert) {
+        std::pair<iterator, bool> result =
+            emplaceKey(key, [&] { return update.value; });
+        if (!result.second) elementOf(result.first) = std::move(update.value);
+      } else {
+        iterator it = find(key);
+        if (it != end()) erase(it);
+      }
+    }
+  }
+
+  void swap(AdaptiveTable &other) {
+    std::swap(layout_, other.layout_);
+    std::swap(small, other.small);
+    std::swap(smallSorted, other.smallSorted);
+    sorted.swap(other.sorted);
+    std::swap(tree, other.tree);
+    std::swap(limits, other.limits);
+    std::swap(reads, other.reads);
+    std::swap(writes, other.writes);
+    std::swap(comp, other.comp);
+  }
+
+  void clear() {
+    small.clear();
+    smallSorted = true;
+    sorted = vector<Value>();
+    delete tree;
+    tree = nullptr;
+    switchTo(adaptive_layout::inline_array);
+  }
+
+  void merge(AdaptiveTable &other) {
+    for (auto it = other.begin(); it != other.end(); ++it) insert(*it);
+    other.clear();
+  }
+
+  iterator find(const Key &key) {
+    ++reads;
+    if (layout_ == adaptive_layout::inline_array) {
+      for (Value &element : small) {
+        if (equivalent(keyOf(element), key)) return iterator(&element);
+      }
+      return end();
+    }
+    if (layout_ == adaptive_layout::sorted_vector) {
+      Value *position = sortedLowerBound(key);
+      if (position != sorted.data() + sorted.size() &&
+          !comp(key, keyOf(*position))) {
+        return iterator(position);
+      }
+      return end();
+    }
+    return iterator(tree->search(key), tree);
+  }
+
+  bool contains(const Key &key) { return find(key) != end(); }
+
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    std::vector<std::pair<iterator, bool>> result;
+    std::vector<value_type> arguments = {args...};
+    for (auto &elem : arguments) {
+      result.push_back(insert(elem));
+    }
+    return result;
+  }
+
+  key_compare key_comp() const { return comp; }
+
+  adaptive_layout layout() const noexcept { return layout_; }
+
+  const adaptive_thresholds &thresholds() const noexcept { return limits; }
+
+  // Takes effect at the next insert or erase.
+  void set_thresholds(const adaptive_thresholds &thresholds) noexcept {
+    limits = thresholds;
+  }
+
+ protected:
+  static const Key &keyOf(const Value &value) noexcept {
+    return KeyOfValue<Key, Value>::get(value);
+  }
+
+  static Value &elementOf(iterator it) noexcept {
+    return it.tree != nullptr ? it.node->data : *it.element;
+  }
+
+  // Find-or-create in a single lookup: make() builds the element only when
+  // the key is absent. A hit counts as a read, an insert as a write.
+  template <typename Make>
+  std::pair<iterator, bool> emplaceKey(const Key &key, Make &&make) {
+    if (layout_ == adaptive_layout::inline_array) {
+      for (Value &element : small) {
+        if (equivalent(keyOf(element), key)) {
+          ++reads;
+          return {iterator(&element), false};
+        }
+      }
+      ++writes;
+      if (small.size() < InlineCapacity) {
+        smallSorted = smallSorted &&
+                      (small.empty() || comp(keyOf(*(small.end() - 1)), key));
+        return {iterator(&small.emplace_back(make())), true};
+      }
+      toSortedVector();
+    }
+    if (layout_ == adaptive_layout::sorted_vector) {
+      Value *position = sortedLowerBound(key);
+      Value *last = sorted.data() + sorted.size();
+      if (position != last && !comp(key, keyOf(*position))) {
+        ++reads;
+        return {iterator(position), false};
+      }
+      ++writes;
+      if (!shouldGrow()) {
+        size_type index = position - sorted.data();
+        sorted.push_back(make());
+        Value *first = sorted.data();
+        std::rotate(first + index, first + sorted.size() - 1,
+                    first + sorted.size());
+        return {iterator(first + index), true};
+      }
+      toTree();
+    }
+    std::pair<typename tree_type::iterator, bool> result =
+        tree->emplaceUnique(key, make);
+    ++(result.second ? writes : reads);
+    return {iterator(result.first.iter, tree), result.second};
+  }
+
+  // Moves to a smaller layout after erases: a sorted vector at half the
+  // inline capacity, a tree once it is small enough and reads have kept up
+  // with writes.
+  void shrink() {
+    if (layout_ == adaptive_layout::sorted_vector) {
+      if (sorted.size() <= InlineCapacity / 2) toInlineArray();
+    } else if (layout_ == adaptive_layout::tree) {
+      if (tree->size() * limits.shrink_ratio <= limits.sorted_max &&
+          reads >= writes) {
+        toSortedVector();
+      }
+    }
+  }
+
+  bool equivalent(const Key &a, const Key &b) const {
+    return !comp(a, b) && !comp(b, a);
+  }
+
+  bool shouldGrow() const {
+    size_type size_ = sorted.size();
+    if (size_ >= limits.sorted_max) return true;
+    return size_ >= limits.write_heavy_min &&
+           writes >= limits.write_heavy_min && writes > reads;
+  }
+
+  Value *contiguousBegin() {
+    if (layout_ == adaptive_layout::sorted_vector) return sorted.data();
+    if (!smallSorted) {
+      std::sort(small.begin(), small.end(),
+                [this](const Value &a, const Value &b) {
+                  return comp(keyOf(a), keyOf(b));
+                });
+      smallSorted = true;
+    }
+    return small.begin();
+  }
+
+  Value *sortedLowerBound(const Key &key) {
+    return std::lower_bound(sorted.data(), sorted.data() + sorted.size(), key,
+                            [this](const Value &element, const Key &probe) {
+                              return comp(keyOf(element), probe);
+                            });
+  }
+
+  void switchTo(adaptive_layout layout) {
+    layout_ = layout;
+    reads = 0;
+    writes = 0;
+  }
+
+  void toSortedVector() {
+    vector<Value> elements;
+    if (layout_ == adaptive_layout::inline_array) {
+      elements.reserve(2 * InlineCapacity);
+      for (Value *it = contiguousBegin(); it != small.end(); ++it) {
+        elements.push_back(*it);
+      }
+      small.clear();
+    } else {
+      elements.reserve(tree->size());
+      for (Node *n = tree->minNode(); n != nullptr; n = n->moveForward()) {
+        elements.push_back(n->data);
+      }
+      delete tree;
+      tree = nullptr;
+    }
+    sorted = std::move(elements);
+    switchTo(adaptive_layout::sorted_vector);
+  }
+
+  void toInlineArray() {
+    for (size_type i = 0; i < sorted.size(); ++i) {
+      small.emplace_back(std::move(sorted.data()[i]));
+    }
+    smallSorted = true;
+    sorted = vector<Value>();
+    switchTo(adaptive_layout::inline_array);
+  }
+
+  // One O(n) bulk build from the sorted elements.
+  void toTree() {
+    std::vector<batch_update<Value>> elements;
+    elements.reserve(sorted.size());
+    for (size_type i = 0; i < sorted.size(); ++i) {
+      elements.push_back({batch_op::insert, std::move(sorted.data()[i])});
+    }
+    tree = new tree_type(comp);
+    tree->applySorted(elements);
+    sorted = vector<Value>();
+    switchTo(adaptive_layout::tree);
+  }
+
+  adaptive_layout layout_ = adaptive_layout::inline_array;
+  mutable SmallBuffer<Value, InlineCapacity> small;
+  mutable bool smallSorted = true;
+  vector<Value> sorted;
+  tree_type *tree = nullptr;
+  adaptive_thresholds limits;
+  size_type reads = 0;
+  size_type writes = 0;
+  Compare comp;
+};
+
+// Set that picks its layout by size and read/write mix; see
+// adaptive_thresholds. Same interface as s21::set.
+template <typename Key, typename Compare = std::less<Key>,
+          typename Balance = avl_balance, std::size_t InlineCapacity = 16>
+class adaptive_set
+    : public AdaptiveTable<Key, Key, Compare, Balance, InlineCapacity> {
+  using base = AdaptiveTable<Key, Key, Compare, Balance, InlineCapacity>;
+
+ public:
+  using value_compare = Compare;
+
+  using base::base;
+
+  value_compare value_comp() const { return this->key_comp(); }
+};
+
+// Map that picks its layout by size and read/write mix; see
+// adaptive_thresholds. Same interface as s21::map.
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Balance = avl_balance, std::size_t InlineCapacity = 16>
+class adaptive_map
+    : public AdaptiveTable<Key, std::pair<Key, T>, Compare, Balance,
+                           InlineCapacity> {
+  using base =
+      AdaptiveTable<Key, std::pair<Key, T>, Compare, Balance, InlineCapacity>;
+
+ public:
+  using mapped_type = T;
+  using typename base::iterator;
+  using typename base::value_type;
+
+  using base::base;
+  using base::insert;
+
+  T &at(const Key &key) {
+    iterator it = this->find(key);
+    if (it == this->end()) throw std::out_of_range("no key found");
+    return it->second;
+  }
+
+  // Inserts a value-initialized element when the key is absent.
+  T &operator[](const Key &key) { return try_emplace(key).first->second; }
+
+  std::pair<iterator, bool> insert(const Key &key, const T &obj) {
+    return insert(value_type(key, obj));
+  }
+
+  std::pair<iterator, bool> insert_or_assign(const Key &key, const T &obj) {
+    std::pair<iterator, bool> result =
+        this->emplaceKey(key, [&] { return value_type(key, obj); });
+    if (!result.second) result.first->second = obj;
+    return result;
+  }
+
+  // Constructs the mapped value from args only if the key is absent; an
+  // existing element is left untouched.
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+    return this->emplaceKey(key, [&] {
+      return value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+    });
+  }
+
+  // Calls fn(T&) on the element for key, value-initializing it first when
+  // the key is absent. Returns whether the element was created.
+  template <typename Fn>
+  std::pair<iterator, bool> upsert(const Key &key, Fn &&fn) {
+    std::pair<iterator, bool> result = try_emplace(key);
+    fn(result.first->second);
+    return result;
+  }
+
+  // Sets the element for key to fn(key, current), where current points to
+  // the existing value or is nullptr; a new element is initialized directly
+  // from the result.
+  template <typename Fn>
+  std::pair<iterator, bool> compute(const Key &key, Fn &&fn) {
+    std::pair<iterator, bool> result = this->emplaceKey(
+        key, [&] { return value_type(key, fn(key, (const T *)nullptr)); });
+    if (!result.second) {
+      T &current = result.first->second;
+      current = fn(key, (const T *)&current);
+    }
+    return result;
+  }
+
+  // Non-throwing lookups: try_get() returns nullptr and get_or() returns
+  // the fallback for an absent key.
+  T *try_get(const Key &key) {
+    iterator it = this->find(key);
+    return it != this->end() ? &it->second : nullptr;
+  }
+
+  T get_or(const Key &key, const T &fallback) {
+    iterator it = this->find(key);
+    return it != this->end() ? it->second : fallback;
+  }
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_ADAPTIVE_H
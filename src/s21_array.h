@@ -2,6 +2,7 @@
 #define S21_CONTAINERS_ARRAY_H
 
 #include  <exception>
+#include <initializer_list>
 #include <limits>
 
 namespace s21 {
@@ -15,24 +16,27 @@ class array {
   using const_iterator = const T*;
   using size_type = std::size_t;
 
-  array() : size_(N) {}
+  // The constructors and element access are constexpr, so an array of
+  // literal types can be built and read in constant expressions.
+  constexpr array() : size_(N) {}
 
-  array(std::initializer_list<value_type> const& items) : size_(N) {
-    std::copy(items.begin(), items.end(), arr_);
+  constexpr array(std::initializer_list<value_type> const& items) : size_(N) {
+    size_type i = 0;
+    for (const_reference item : items) arr_[i++] = item;
   }
 
-  array(const array& a) : size_(a.size_) {
-    std::copy(a.begin(), a.end(), arr_);
+  constexpr array(const array& a) : size_(a.size_) {
+    for (size_type i = 0; i < size_; ++i) {
+      arr_[i] = a.arr_[i];
+    }
   }
 
-  array(array&& a) : size_(a.size_) {
+  constexpr array(array&& a) : size_(a.size_) {
     for (size_type i = 0; i < size_; ++i) {
       arr_[i] = a.arr_[i];
     }
   }
 
-  ~array() {}
-
   array<T, N>& operator=(array<T, N>&& a) noexcept {
     if (this != &a) {
       for (size_type i = 0; i < size_; ++i) {
@@ -48,7 +52,11 @@ class array {
     return arr_[pos];
   }
 
-  reference operator[](size_type pos) { return *(arr_ + pos); }
+  constexpr reference operator[](size_type pos) { return *(arr_ + pos); }
+
+  constexpr const_reference operator[](size_type pos) const {
+    return arr_[pos];
+  }
 
   const_reference front() { return *arr_; }
 
@@ -61,13 +69,13 @@ class array {
       return arr_;
   }
 
-  iterator begin() { return iterator(arr_); }
+  constexpr iterator begin() { return iterator(arr_); }
 
-  const_iterator begin() const { return const_iterator(arr_); }
+  constexpr const_iterator begin() const { return const_iterator(arr_); }
 
-  iterator end() { return arr_ + size_; }
+  constexpr iterator end() { return arr_ + size_; }
 
-  const_iterator end() const { return arr_ + size_; }
+  constexpr const_iterator end() const { return arr_ + size_; }
 
   bool empty() { return size_ == 0; }
 
@@ -1,13 +1,229 @@
 #ifndef S21_CONTAINERS_BINARY_TREE_H
 #define S21_CONTAINERS_BINARY_TREE_H
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <limits>
+#include <map>
+#include <new>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_node_arena.h"
+#include "s21_reclaimer.h"
+#include "s21_tree_balance.h"
 
 namespace s21 {
-template <typename key_, typename value_, typename compare_>
-class BinaryTree {
+// Three-way comparison used by every tree descent: negative if a orders
+// before b, zero if they are equivalent, positive otherwise. The generic
+// version asks the comparator at most twice; strings under the default
+// ordering are compared once with string::compare.
+template <typename A, typename B, typename compare_>
+int threeWayCompare(const A &a, const B &b, const compare_ &compare) {
+  return compare(a, b) ? -1 : (compare(b, a) ? 1 : 0);
+}
+
+inline int threeWayCompare(const std::string &a, const std::string &b,
+                           const std::less<std::string> &) {
+  return a.compare(b);
+}
+
+inline int threeWayCompare(const std::string &a, const std::string &b,
+                           const std::less<> &) {
+  return a.compare(b);
+}
+
+// Keeps the comparator inside the tree; empty (stateless) comparators are
+// stored as a base class so they take no space.
+template <typename compare_, bool = std::is_empty<compare_>::value &&
+                                    !std::is_final<compare_>::value>
+class CompareHolder : private compare_ {
+ public:
+  CompareHolder() = default;
+  explicit CompareHolder(const compare_ &compare) : compare_(compare) {}
+
+  const compare_ &keyCompare() const noexcept { return *this; }
+
+ protected:
+  void setKeyCompare(const compare_ &) noexcept {}
+};
+
+template <typename compare_>
+class CompareHolder<compare_, false> {
+ public:
+  CompareHolder() = default;
+  explicit CompareHolder(const compare_ &compare) : compare(compare) {}
+
+  const compare_ &keyCompare() const noexcept { return compare; }
+
+ protected:
+  void setKeyCompare(const compare_ &other) { compare = other; }
+
+ private:
+  compare_ compare{};
+};
+
+// Operation counters kept by every tree when S21_CONTAINERS_STATS is
+// defined. Without it the counting calls are empty and the tree carries no
+// counter storage, so builds that leave stats off pay nothing.
+struct tree_counters {
+  std::size_t comparisons = 0;
+  std::size_t rotations = 0;
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+  std::size_t rebalance_steps = 0;
+};
+
+#ifdef S21_CONTAINERS_STATS
+inline constexpr bool kTreeStats = true;
+#else
+inline constexpr bool kTreeStats = false;
+#endif
+
+template <bool = kTreeStats>
+class CounterHolder {
+ public:
+  const tree_counters &counters() const noexcept { return counters_; }
+  void resetCounters() noexcept { counters_ = tree_counters(); }
+
+ protected:
+  void countEvent(std::size_t tree_counters::*counter,
+             std::size_t amount = 1) const noexcept {
+    counters_.*counter += amount;
+  }
+
+ private:
+  mutable tree_counters counters_;
+};
+
+template <>
+class CounterHolder<false> {
+ public:
+  tree_counters counters() const noexcept { return tree_counters(); }
+  void resetCounters() noexcept {}
+
+ protected:
+  void countEvent(std::size_t tree_counters::*,
+                  std::size_t = 1) const noexcept {}
+};
+
+// Shape of a tree as reported by stats(). Depths count nodes from the root,
+// which is at depth 1, so average_depth is the number of nodes a successful
+// lookup visits on average. balance_histogram maps the height difference
+// right - left of each node to the number of nodes with it.
+struct tree_stats {
+  std::size_t size = 0;
+  std::size_t height = 0;
+  double average_depth = 0.0;
+  std::size_t node_bytes = 0;
+  double bytes_per_element = 0.0;
+  std::map<int, std::size_t> balance_histogram;
+  tree_counters counters;
+};
+
+// Node keys are the values themselves for set/multiset and the first member
+// of the stored pair for map; other stored types provide a key() accessor.
+template <typename key_, typename value_, typename = void>
+struct KeyOfValue {
+  static const key_ &get(const value_ &value) noexcept { return value.first; }
+};
+
+template <typename key_, typename value_>
+struct KeyOfValue<key_, value_,
+                  std::void_t<decltype(std::declval<const value_ &>().key())>> {
+  static const key_ &get(const value_ &value) noexcept { return value.key(); }
+};
+
+template <typename key_>
+struct KeyOfValue<key_, key_> {
+  static const key_ &get(const key_ &value) noexcept { return value; }
+};
+
+// Inline key prefix stored in every tree node. Only string keys ordered by
+// the default comparator carry one: their first 8 bytes are packed
+// big-endian into an integer, so most node comparisons are decided without
+// touching the string's heap buffer. Define S21_CONTAINERS_NO_KEY_PREFIX to
+// keep the plain node layout.
+template <typename key_>
+struct KeyPrefix {
+  static constexpr bool enabled = false;
+
+  KeyPrefix() = default;
+  template <typename K>
+  explicit KeyPrefix(const K &) noexcept {}
+};
+
+#ifndef S21_CONTAINERS_NO_KEY_PREFIX
+template <>
+struct KeyPrefix<std::string> {
+  static constexpr bool enabled = true;
+
+  KeyPrefix() = default;
+  explicit KeyPrefix(const std::string &key) noexcept {
+    for (std::size_t i = 0; i < 8; ++i) {
+      unsigned char byte = (i < key.size()) ? key[i] : 0;
+      prefix = (prefix << 8) | byte;
+    }
+  }
+
+  int compare(const KeyPrefix &other) const noexcept {
+    return (prefix < other.prefix) ? -1 : ((prefix > other.prefix) ? 1 : 0);
+  }
+
+  // Called only when the prefixes are equal: if both strings are at least 8
+  // bytes long their first 8 bytes match and only the tails are compared.
+  static int compareRest(const std::string &a, const std::string &b) {
+    if (a.size() < 8 || b.size() < 8) return a.compare(b);
+    return a.compare(8, std::string::npos, b, 8, std::string::npos);
+  }
+
+  std::uint64_t prefix = 0;
+};
+#endif
+
+template <typename key_, typename compare_>
+struct UsesKeyPrefix
+    : std::integral_constant<
+          bool, KeyPrefix<key_>::enabled &&
+                    (std::is_same<compare_, std::less<key_>>::value ||
+                     std::is_same<compare_, std::less<>>::value)> {};
+
+// One entry of a batch passed to apply_batch. For an erase only the key part
+// of value is used.
+enum class batch_op { insert, erase };
+
+template <typename value_>
+struct batch_update {
+  batch_op op;
+  value_ value;
+};
+
+// In-order threads carried by the nodes of threaded trees; empty otherwise.
+template <typename node_, bool = true>
+struct ThreadLinks {
+  node_ *prev = nullptr;
+  node_ *next = nullptr;
+};
+
+template <typename node_>
+struct ThreadLinks<node_, false> {};
+
+// Node order produced by compaction: key order, which suits full scans, or
+// van Emde Boas order, which keeps every short root-to-leaf path segment in
+// a few cache lines and suits point lookups.
+enum class node_layout { in_order, van_emde_boas };
+
+template <typename key_, typename value_, typename compare_,
+          typename balance_ = avl_balance>
+class BinaryTree : public CompareHolder<compare_>, public CounterHolder<> {
  public:
   class Node;
   struct treeIterator;
@@ -22,23 +238,49 @@ class BinaryTree {
   using size_type = std::size_t;
   using iterator = treeIterator;
   using const_iterator = treeIteratorConst;
-
-  BinaryTree() : root(new Node), size_(0){};
-
-  BinaryTree(const BinaryTree &other) : root(nullptr), size_(other.size_) {
-    root = root->copyNode(other.root);
+  using key_compare = compare_;
+  using balance_type = balance_;
+  using balance_fields = typename balance_::node_fields;
+  using prefix_type =
+      typename std::conditional<UsesKeyPrefix<key_, compare_>::value,
+                                KeyPrefix<key_type>, KeyPrefix<void>>::type;
+
+  static constexpr bool kThreaded = IsThreaded<balance_>::value;
+
+  // An empty tree has no root node, so constructing, moving from and
+  // clearing a tree allocate nothing.
+  BinaryTree() : root(nullptr), size_(0){};
+
+  explicit BinaryTree(const compare_ &compare)
+      : CompareHolder<compare_>(compare), root(nullptr), size_(0){};
+
+  BinaryTree(const BinaryTree &other)
+      : CompareHolder<compare_>(other.keyCompare()),
+        root(nullptr),
+        size_(other.size_) {
+    if (!other.empty()) root = copyNodes(other.root, other.size_);
+    countEvent(&tree_counters::allocations, size_);
+    rethread();
   }
 
   BinaryTree(BinaryTree &&other) noexcept
-      : root(other.root), size_(other.size_) {
+      : CompareHolder<compare_>(other.keyCompare()),
+        root(other.root),
+        size_(other.size_) {
+    other.cancelCompaction();
+    compaction = std::exchange(other.compaction, nullptr);
     other.size_ = 0;
-    other.root = new Node();
+    other.root = nullptr;
   }
 
   BinaryTree &operator=(const BinaryTree &other) {
     if (this != &other) {
+      deleteTree();
+      this->setKeyCompare(other.keyCompare());
       size_ = other.size_;
-      root->copyNode(other.root);
+      if (!other.empty()) root = copyNodes(other.root, other.size_);
+      countEvent(&tree_counters::allocations, size_);
+      rethread();
     }
     return *this;
   };
@@ -46,21 +288,40 @@ class BinaryTree {
   BinaryTree &operator=(BinaryTree &&other) noexcept {
     if (this != &other) {
       deleteTree();
+      other.cancelCompaction();
+      delete compaction;
+      compaction = std::exchange(other.compaction, nullptr);
+      this->setKeyCompare(other.keyCompare());
       size_ = other.size_;
       root = other.root;
 
       other.size_ = 0;
-      other.root = new Node();
+      other.root = nullptr;
     }
     return *this;
   }
 
-  ~BinaryTree() { deleteTree(); }
+  void swap(BinaryTree &other) {
+    compare_ comp = this->keyCompare();
+    this->setKeyCompare(other.keyCompare());
+    other.setKeyCompare(comp);
+    std::swap(root, other.root);
+    std::swap(size_, other.size_);
+    std::swap(compaction, other.compaction);
+  }
+
+  ~BinaryTree() {
+    deleteTree();
+    delete compaction;
+  }
 
-  void deleteTree() {
+  // With deferred set, the nodes are handed to the background reclaimer
+  // instead of being freed on the calling thread.
+  void deleteTree(bool deferred = false) {
+    cancelCompaction();
     if (root) {
+      releaseNodes(root, size_, deferred);
       size_ = 0;
-      root->clearNode(root);
       root = nullptr;
     }
   }
@@ -75,221 +336,455 @@ class BinaryTree {
   }
 
   std::pair<iterator, bool> insertUnique(value_type item) {
-    std::pair<iterator, bool> result = insert(item, root, true);
-    if (result.second == true) increaseSize();
-    return result;
+    return insert(item, true);
   }
 
   std::pair<iterator, bool> insertNonUnique(value_type item) {
-    std::pair<iterator, bool> result = insert(item, root, false);
-    if (result.second == true) increaseSize();
-    return result;
+    return insert(item, false);
   }
 
-  std::pair<iterator, bool> insert(value_type item, Node *n, bool isUnique) {
-    std::pair<iterator, bool> result = {iterator(n, root), true};
+  // Iterative descent to the insertion point; equal keys go to the right
+  // so that equivalent elements keep their insertion order.
+  std::pair<iterator, bool> insert(const value_type &item, bool isUnique) {
     if (empty()) {
-      root->data = item;
-      return result;
+      root = newNode(item);
+      increaseSize();
+      balance_::afterInsert(*this, root);
+      return {iterator(root, root), true};
     }
-    if (compare_Keys(item, n->data)) {
-      if (n->left == nullptr) {
-        n->left = new Node(item);
-        n->left->parent = n;
-      } else {
-        result = insert(item, n->left, isUnique);
-      }
-    } else if (compare_Keys(n->data, item)) {
-      if (n->right == nullptr) {
-        n->right = new Node(item);
-        n->right->parent = n;
-      } else {
-        result = insert(item, n->right, isUnique);
-      }
-    } else {
-      if (isUnique == true) {
-        result = {iterator(n, root), false};
-      } else {
-        if (n->right == nullptr) {
-          n->right = new Node(item);
-          n->right->parent = n;
-        } else {
-          result = insert(item, n->right, isUnique);
-        }
-      }
+    const key_type &key = keyOf(item);
+    prefix_type prefix = makePrefix(key);
+    Node *parent = root;
+    bool toLeft = false;
+    for (Node *current = root; current != nullptr;) {
+      int cmp = compareToNode(key, prefix, current);
+      if (cmp == 0 && isUnique) return {iterator(current, root), false};
+      parent = current;
+      toLeft = cmp < 0;
+      current = toLeft ? current->left : current->right;
     }
-    balance(n);
-    return result;
+    Node *node = newNode(item);
+    linkNode(node, parent, toLeft);
+    return {iterator(node, root), true};
   }
 
-  void balance(Node *node) {
-    node->updateHeight();
-    int temp = node->bfactor();
-    if (temp == 2) {
-      if (node->right != nullptr) {
-        if (node->right->bfactor() < 0) node->right = rotateRight(node->right);
-      }
-      node = rotateLeft(node);
+  // Unique insert that builds the element only when the key is absent:
+  // make() is called once on the insert path and its result initializes the
+  // node in place, so a hit costs one descent and no element construction.
+  template <typename Make>
+  std::pair<iterator, bool> emplaceUnique(const key_type &key, Make &&make) {
+    if (empty()) {
+      root = newNode(EmplaceTag(), make);
+      increaseSize();
+      balance_::afterInsert(*this, root);
+      return {iterator(root, root), true};
     }
-    if (temp == -2) {
-      if (node->left != nullptr) {
-        if (node->left->bfactor() > 0) node->left = rotateLeft(node->left);
-      }
-      node = rotateRight(node);
+    prefix_type prefix = makePrefix(key);
+    Node *parent = root;
+    bool toLeft = false;
+    for (Node *current = root; current != nullptr;) {
+      int cmp = compareToNode(key, prefix, current);
+      if (cmp == 0) return {iterator(current, root), false};
+      parent = current;
+      toLeft = cmp < 0;
+      current = toLeft ? current->left : current->right;
     }
+    Node *node = newNode(EmplaceTag(), make);
+    linkNode(node, parent, toLeft);
+    return {iterator(node, root), true};
   }
 
-  Node *rotateRight(Node *p) {
-    Node *q = p->left;
-    if (root == p) {
-      root = q;
+  // Hangs a new leaf under parent and lets the balancing policy restore its
+  // invariant.
+  void linkNode(Node *node, Node *parent, bool toLeft) {
+    node->parent = parent;
+    (toLeft ? parent->left : parent->right) = node;
+    if constexpr (kThreaded) {
+      node->prev = toLeft ? parent->prev : parent;
+      node->next = toLeft ? parent : parent->next;
+      if (node->prev != nullptr) node->prev->next = node;
+      if (node->next != nullptr) node->next->prev = node;
+    }
+    increaseSize();
+    balance_::afterInsert(*this, node);
+  }
+
+  // Augmented policies also get the tree, for its comparator.
+  void updateFields(Node *node) {
+    if constexpr (IsAugmented<balance_>::value) {
+      balance_::update(*this, node);
     } else {
-      if (p->parent->left == p) p->parent->left = q;
-      if (p->parent->right == p) p->parent->right = q;
+      balance_::update(node);
     }
+  }
+
+  // Rotations recompute the policy fields of the two nodes they move;
+  // ancestors are refreshed by the policy's fix-up walk.
+  Node *rotateRight(Node *p) {
+    countEvent(&tree_counters::rotations);
+    Node *q = p->left;
+    replaceChild(p->parent, p, q);
     q->parent = p->parent;
 
     p->left = q->right;
     q->right = p;
-    if (p->left) p->left->parent = q;
+    if (p->left) p->left->parent = p;
     p->parent = q;
-    q->updateHeight();
+    updateFields(p);
+    updateFields(q);
     return q;
   }
 
   Node *rotateLeft(Node *q) {
+    countEvent(&tree_counters::rotations);
     Node *p = q->right;
-    if (root == q) {
-      root = p;
-    } else {
-      if (q->parent->left == q) q->parent->left = p;
-      if (q->parent->right == q) q->parent->right = p;
-    }
+    replaceChild(q->parent, q, p);
     p->parent = q->parent;
 
     q->right = p->left;
     p->left = q;
     if (q->right) q->right->parent = q;
     q->parent = p;
-    p->updateHeight();
+    updateFields(q);
+    updateFields(p);
     return p;
   }
 
-  bool contains(const key_ &key) const {
-    return root->search(key) ? true : false;
+  template <typename K>
+  bool contains(const K &key) const {
+    return search(key) ? true : false;
   }
 
-  iterator find(const key_ &key) const {
-    iterator it(root->search(key), root);
-    if (it.iter == nullptr) throw std::out_of_range("no key found");
-    return it;
+  // Returns the end iterator when the key is absent.
+  template <typename K>
+  iterator find(const K &key) const {
+    return iterator(search(key), root);
   }
 
   void increaseSize() noexcept { size_++; }
   void decreaseSize() noexcept { size_--; }
 
+  // Unlinks and frees the node. A node with two children first trades
+  // places with its in-order successor, so only links move: iterators and
+  // references to all other elements stay valid.
   void erase(iterator pos) {
     Node *p = pos.iter;
-    Node *newNode = remove(p);
-    delete p;
-    p = nullptr;
-    if (newNode) balance(newNode);
-    if (!root) root = new Node();
+    if (p->left != nullptr && p->right != nullptr) {
+      swapWithSuccessor(p);
+    }
+    Node *child = (p->left != nullptr) ? p->left : p->right;
+    Node *parent = p->parent;
+    replaceChild(parent, p, child);
+    if (child != nullptr) child->parent = parent;
+    balance_fields removed = p->fields;
+    if constexpr (kThreaded) {
+      if (p->prev != nullptr) p->prev->next = p->next;
+      if (p->next != nullptr) p->next->prev = p->prev;
+    }
+    cancelCompaction();
+    freeNode(p);
+    countEvent(&tree_counters::deallocations);
     decreaseSize();
+    if (root != nullptr) balance_::afterErase(*this, parent, child, removed);
   }
 
-  Node *remove(Node *p) {
-    Node *newNode = nullptr;
-    if (p == nullptr) return newNode;
+  // Orders a batch by key and keeps only the last update of each key, which
+  // gives the same result as applying the batch one update at a time.
+  template <typename Update>
+  void applyBatch(std::vector<Update> updates) {
+    const compare_ &comp = this->keyCompare();
+    std::stable_sort(updates.begin(), updates.end(),
+                     [&](const Update &a, const Update &b) {
+                       return comp(keyOf(a.value), keyOf(b.value));
+                     });
+    size_type kept = 0;
+    for (size_type i = 0; i < updates.size(); ++i) {
+      bool lastOfKey =
+          i + 1 == updates.size() ||
+          comp(keyOf(updates[i].value), keyOf(updates[i + 1].value));
+      if (lastOfKey) {
+        if (kept != i) updates[kept] = std::move(updates[i]);
+        ++kept;
+      }
+    }
+    updates.resize(kept);
+    applySorted(updates);
+  }
 
-    if (p->left != nullptr && p->right != nullptr) {
-      newNode = removeTwoChildNode(p);
-    } else if ((p->left == nullptr) xor (p->right == nullptr)) {
-      newNode = removeOneChildNode(p);
+  // Applies updates sorted by key with no repeated keys: an insert adds its
+  // value or overwrites the equal element, an erase removes the element if
+  // present. Batches of at least 1/kRebuildRatio of the tree are merged with
+  // the in-order node sequence and the tree is rebuilt in one pass; smaller
+  // ones locate each key by finger search from the previous position.
+  template <typename Update>
+  void applySorted(const std::vector<Update> &updates) {
+    if (updates.size() * kRebuildRatio >= size_) {
+      mergeRebuild(updates);
+      return;
+    }
+    Node *finger = nullptr;
+    for (const Update &update : updates) {
+      bool isErase = update.op == batch_op::erase;
+      if (empty()) {
+        if (!isErase) finger = insert(update.value, true).first.iter;
+        continue;
+      }
+      const key_type &key = keyOf(update.value);
+      prefix_type prefix = makePrefix(key);
+      Node *parent = nullptr;
+      bool toLeft = false;
+      Node *current = fingerStart(finger, key, prefix);
+      int cmp = 1;
+      while (current != nullptr) {
+        cmp = compareToNode(key, prefix, current);
+        if (cmp == 0) break;
+        parent = current;
+        toLeft = cmp < 0;
+        current = toLeft ? current->left : current->right;
+      }
+      if (isErase) {
+        // The finger is left in place: its key is below this one, so it is
+        // never the erased node and stays a valid start for the next key.
+        if (current != nullptr) erase(iterator(current, root));
+      } else if (current != nullptr) {
+        current->data = update.value;
+        refreshPath(current);
+        finger = current;
+      } else {
+        finger = newNode(update.value);
+        linkNode(finger, parent, toLeft);
+      }
     }
+  }
 
-    if (p != root) {
-      (p->parent->left == p) ? p->parent->left = newNode
-                             : p->parent->right = newNode;
-    } else {
-      root = newNode;
+  // Removes every element matching pred in one in-order pass, then rebuilds
+  // the survivors into a balanced tree instead of rebalancing per erase.
+  template <typename Pred>
+  size_type eraseIf(Pred pred) {
+    if (empty()) return 0;
+    cancelCompaction();
+    std::vector<Node *> nodes = inOrderNodes();
+    size_type kept = 0;
+    for (Node *n : nodes) {
+      if (pred(static_cast<const value_type &>(n->data))) {
+        freeNode(n);
+      } else {
+        nodes[kept++] = n;
+      }
     }
+    size_type removed = nodes.size() - kept;
+    countEvent(&tree_counters::deallocations, removed);
+    if (removed == 0) return 0;
+    nodes.resize(kept);
+    rebuildFrom(nodes);
+    return removed;
+  }
+
+  // Called by the balancing policies once per node their fix-ups visit.
+  void noteRebalanceStep() const noexcept {
+    countEvent(&tree_counters::rebalance_steps);
+  }
 
-    return newNode;
+  // Walks the whole tree breadth-first, so degenerate shapes need no deep
+  // recursion; heights are then folded bottom-up over the same order.
+  tree_stats stats() const {
+    tree_stats result;
+    result.size = size_;
+    result.node_bytes = sizeof(Node);
+    result.counters = counters();
+    if (empty()) return result;
+    struct Entry {
+      const Node *node;
+      size_type depth;
+      size_type left;
+      size_type right;
+    };
+    const size_type none = std::numeric_limits<size_type>::max();
+    std::vector<Entry> order;
+    order.reserve(size_);
+    order.push_back({root, 1, none, none});
+    size_type depthSum = 0;
+    for (size_type i = 0; i < order.size(); ++i) {
+      const Node *n = order[i].node;
+      size_type depth = order[i].depth;
+      depthSum += depth;
+      if (n->left != nullptr) {
+        order[i].left = order.size();
+        order.push_back({n->left, depth + 1, none, none});
+      }
+      if (n->right != nullptr) {
+        order[i].right = order.size();
+        order.push_back({n->right, depth + 1, none, none});
+      }
+    }
+    std::vector<size_type> heights(order.size());
+    for (size_type i = order.size(); i-- > 0;) {
+      size_type left = order[i].left == none ? 0 : heights[order[i].left];
+      size_type right = order[i].right == none ? 0 : heights[order[i].right];
+      heights[i] = 1 + std::max(left, right);
+      ++result.balance_histogram[int(right) - int(left)];
+    }
+    result.height = heights[0];
+    result.average_depth = double(depthSum) / double(size_);
+    result.bytes_per_element =
+        double(sizeof(*this) + sizeof(Node) * size_) / double(size_);
+    return result;
   }
 
-  Node *removeOneChildNode(Node *p) {
-    Node *newNode = (p->left == nullptr) ? p->right : p->left->getMax();
-    newNode->parent = p->parent;
-    return newNode;
+  // Calls fn on every element with a key in [lo, hi), in key order. The end
+  // node is found up front, so the scan itself compares no keys; threaded
+  // trees also prefetch a few nodes ahead of the cursor.
+  template <typename K, typename Fn>
+  void forEachInRange(const K &lo, const K &hi, Fn &&fn) const {
+    if (!this->keyCompare()(lo, hi)) return;
+    Node *last = boundNode(hi, false);
+    Node *n = boundNode(lo, false);
+    Node *ahead = n;
+    if constexpr (kThreaded) {
+      for (int i = 0; i < kPrefetchDistance && ahead != last; ++i) {
+        ahead = ahead->next;
+        prefetch(ahead);
+      }
+    }
+    for (; n != last; n = n->moveForward()) {
+      if constexpr (kThreaded) {
+        if (ahead != last) {
+          ahead = ahead->next;
+          prefetch(ahead);
+        }
+      }
+      fn(n->data);
+    }
   }
 
-  Node *removeTwoChildNode(Node *p) {
-    Node *maxInLeft = p->left->getMax();
-    Node *newNode = maxInLeft;
+  // Recomputes the cached subtree summaries above a node whose value was
+  // changed in place; does nothing unless the balance policy is augmented.
+  void refreshPath(Node *node) {
+    if constexpr (IsAugmented<balance_>::value) {
+      balance_::refreshPath(*this, node);
+    }
+  }
 
-    newNode->right = p->right;
-    if (p->right) newNode->right->parent = newNode;
+  // Combines the summaries of the elements with keys in [lo, hi), in key
+  // order, from O(log n) cached subtree summaries: one descent to the node
+  // where the bounds part, then one along each bound.
+  template <typename K>
+  auto aggregate(const K &lo, const K &hi) const {
+    using augment = typename balance_::augment_type;
+    if (!this->keyCompare()(lo, hi)) return augment::identity();
+    return aggregateRange(&lo, true, &hi);
+  }
 
-    maxInLeft->parent->right = maxInLeft->left;
-    if (maxInLeft->left) maxInLeft->left->parent = maxInLeft->parent;
+  // Calls fn(mine, theirs) for every key whose element differs between this
+  // tree and other, with nullptr for a side that lacks the key. Needs an
+  // augmentation whose summaries of equal key ranges are equal exactly when
+  // the contents are (up to hash collisions), such as merkle. Subtrees of
+  // this tree whose summary matches the same key range of other are
+  // skipped, so the cost grows with the number of differences, not with
+  // the tree size.
+  template <typename Fn>
+  void diffAgainst(const BinaryTree &other, Fn &&fn) const {
+    diffSubtree(empty() ? nullptr : root, nullptr, nullptr, other, fn);
+  }
 
-    newNode->parent = p->parent;
+  // Relocates every node into one contiguous block in the given order so
+  // that scans and descents walk adjacent memory. Iterators and pointers to
+  // elements are invalidated.
+  void compact(node_layout layout) {
+    beginCompaction(layout);
+    compactStep(std::numeric_limits<size_type>::max());
+  }
 
-    if (p->left != newNode) {
-      newNode->left = p->left;
-      newNode->left->parent = newNode;
+  // Incremental form: beginCompaction fixes the order and each compactStep
+  // moves at most maxNodes nodes, returning true once all have moved.
+  // Inserts may run between steps; an erase or clear abandons the rest of
+  // the plan, and nodes already moved stay in place.
+  void beginCompaction(node_layout layout) {
+    cancelCompaction();
+    if (empty()) return;
+    if (compaction == nullptr) compaction = new Compaction;
+    std::vector<Node *> &plan = compaction->plan;
+    if (layout == node_layout::in_order) {
+      plan = inOrderNodes();
+    } else {
+      plan.reserve(size_);
+      vanEmdeBoasOrder(root, subtreeHeight(root), plan);
     }
+    compaction->arena.openBlock(plan.size());
+  }
+
+  bool compactStep(size_type maxNodes) {
+    if (!compacting()) return true;
+    std::vector<Node *> &plan = compaction->plan;
+    size_type &position = compaction->position;
+    for (size_type moved = 0; moved < maxNodes && position < plan.size();
+         ++moved) {
+      relocate(plan[position++], compaction->arena.nextSlot());
+    }
+    if (position < plan.size()) return false;
+    cancelCompaction();
+    return true;
+  }
 
-    return newNode;
+  bool compacting() const noexcept {
+    return compaction != nullptr && !compaction->plan.empty();
   }
 
-  void clearTree() {
+  void clearTree(bool deferred = false) {
+    cancelCompaction();
     if (root) {
+      releaseNodes(root, size_, deferred);
       size_ = 0;
-      root->clearNode(root);
+      root = nullptr;
     }
-    root = new Node();
   }
 
-  iterator findLowerBound(const_reference key) const {
-    Node *start = root;
-    Node *result = nullptr;
-
-    while (start != nullptr) {
-      if ((start->data >= key)) {
-        result = start;
-        start = start->left;
-      } else {
-        start = start->right;
-      }
+  // Single-descent lookup: one three-way comparison per visited node.
+  template <typename K>
+  Node *search(const K &key) const {
+    if (empty()) return nullptr;
+    prefix_type prefix = makePrefix(key);
+    Node *current = root;
+    while (current != nullptr) {
+      int cmp = compareToNode(key, prefix, current);
+      if (cmp == 0) return current;
+      current = (cmp < 0) ? current->left : current->right;
     }
-    return iterator(result, root);
+    return nullptr;
   }
 
-  iterator findUpperBound(const_reference key) const {
-    Node *start = root;
-    Node *result = nullptr;
-    while (start != nullptr) {
-      if (start->data > key) {
-        result = start;
-        start = start->left;
-      } else
-        start = start->right;
-    }
+  template <typename K>
+  iterator findLowerBound(const K &key) const {
+    return iterator(boundNode(key, false), root);
+  }
+
+  template <typename K>
+  iterator findUpperBound(const K &key) const {
+    return iterator(boundNode(key, true), root);
+  }
 
-    return iterator(result, root);
+  template <typename K>
+  size_type count(const K &key) const {
+    size_type result = 0;
+    Node *end = boundNode(key, true);
+    for (Node *n = boundNode(key, false); n != end; n = n->moveForward()) {
+      ++result;
+    }
+    return result;
   }
 
-  size_type count(const key_ &key) const noexcept {
-    return root->countNonUnique(key);
+  template <typename K>
+  iterator at(const K &key) const {
+    return iterator(search(key), root);
   }
 
-  iterator at(const key_ &key) const {
-    return iterator(root->getPair(key), root);
+  template <typename K>
+  bool containsPair(const K &key) const {
+    return contains(key);
   }
-  bool containsPair(const key_ &key) const {
-    return root->getPair(key) ? true : false;
+
+  static const key_type &keyOf(const value_type &value) noexcept {
+    return KeyOfValue<key_type, value_type>::get(value);
   }
 
   Node *getRoot() const noexcept { return root; }
@@ -315,9 +810,10 @@ class BinaryTree {
 
     iterator &operator--() {
       if (iter == nullptr && root != nullptr) {
-        iter = root->getMin();
+        iter = root->getMax();
+      } else {
+        iter = iter->moveBack();
       }
-      iter = iter->moveBack();
       return *this;
     }
 
@@ -339,7 +835,7 @@ class BinaryTree {
 
     const_reference operator*() const {
       if (iter == nullptr && root != nullptr) {
-        root->getMax();
+        return root->getMax()->data;
       }
       return iter->data;
     }
@@ -354,9 +850,10 @@ class BinaryTree {
 
     const_iterator &operator--() {
       if (iter == nullptr && root != nullptr) {
-        iter = root->getMin();
+        iter = root->getMax();
+      } else {
+        iter = iter->moveBack();
       }
-      iter = iter->moveBack();
       return *this;
     }
 
@@ -373,26 +870,578 @@ class BinaryTree {
   };
 
  private:
+  struct EmplaceTag {};
+
+  void replaceChild(Node *parent, Node *oldChild, Node *newChild) noexcept {
+    if (parent == nullptr) {
+      root = newChild;
+    } else if (parent->left == oldChild) {
+      parent->left = newChild;
+    } else {
+      parent->right = newChild;
+    }
+  }
+
+  // Exchanges the tree positions (links and policy fields) of a node with
+  // two children and its successor; afterwards the node has no left child.
+  void swapWithSuccessor(Node *node) {
+    Node *next = node->right->getMin();
+    Node *parent = node->parent;
+    Node *left = node->left;
+    Node *right = node->right;
+    Node *nextParent = next->parent;
+    Node *nextRight = next->right;
+
+    replaceChild(parent, node, next);
+    next->parent = parent;
+    next->left = left;
+    left->parent = next;
+    if (right == next) {
+      next->right = node;
+      node->parent = next;
+    } else {
+      next->right = right;
+      right->parent = next;
+      nextParent->left = node;
+      node->parent = nextParent;
+    }
+    node->left = nullptr;
+    node->right = nextRight;
+    if (nextRight != nullptr) nextRight->parent = node;
+    std::swap(node->fields, next->fields);
+  }
+
+  static constexpr size_type kRebuildRatio = 8;
+  static constexpr int kPrefetchDistance = 4;
+  static constexpr size_type kParallelThreshold = size_type(1) << 16;
+  static constexpr unsigned kMaxParallelTasks = 16;
+
+  static void prefetch(const Node *node) noexcept {
+#if defined(__GNUC__)
+    if (node != nullptr) __builtin_prefetch(node);
+#else
+    (void)node;
+#endif
+  }
+
+  template <typename... Args>
+  Node *newNode(Args &&...args) {
+    countEvent(&tree_counters::allocations);
+    return new Node(std::forward<Args>(args)...);
+  }
+
+  void freeNode(Node *node) {
+    if (compaction == nullptr || !compaction->arena.destroy(node)) {
+      delete node;
+    } else {
+      dropEmptyCompaction();
+    }
+  }
+
+  // Heap nodes of large trees are freed by several threads, or by the
+  // background reclaimer when deferred. While the arena still holds
+  // relocated nodes the walk stays on this thread, because the arena's
+  // bookkeeping is not shared between threads; the arena is dropped with
+  // its last node, after which teardown takes the fast paths again.
+  void releaseNodes(Node *top, size_type nodes, bool deferred) {
+    countEvent(&tree_counters::deallocations, nodes);
+    if (compaction != nullptr) {
+      destroySubtree(top, [this](Node *node) { freeNode(node); });
+    } else if (deferred) {
+      Reclaimer::instance().submit([top, nodes] { deleteNodes(top, nodes); });
+    } else {
+      deleteNodes(top, nodes);
+    }
+  }
+
+  static unsigned parallelTasks(size_type count) {
+    if (count < kParallelThreshold) return 1;
+    unsigned threads = std::thread::hardware_concurrency();
+    return std::min(threads, kMaxParallelTasks);
+  }
+
+  // Levels copied or freed on the calling thread before the subtrees below
+  // them are split between tasks.
+  static int splitLevels(unsigned tasks) {
+    int levels = 0;
+    while ((1u << levels) < tasks) ++levels;
+    return levels;
+  }
+
+  static Node *cloneNode(const Node *source, Node *parent) {
+    Node *copy = new Node(*source);
+    copy->left = copy->right = nullptr;
+    copy->parent = parent;
+    return copy;
+  }
+
+  // Copies a subtree without recursion or a stack: the walk follows parent
+  // links in both trees, and a missing child copy marks an unvisited side.
+  static Node *copySubtree(const Node *source, Node *parent) {
+    Node *top = cloneNode(source, parent);
+    Node *copy = top;
+    const Node *current = source;
+    while (true) {
+      if (current->left != nullptr && copy->left == nullptr) {
+        copy->left = cloneNode(current->left, copy);
+        current = current->left;
+        copy = copy->left;
+      } else if (current->right != nullptr && copy->right == nullptr) {
+        copy->right = cloneNode(current->right, copy);
+        current = current->right;
+        copy = copy->right;
+      } else if (current == source) {
+        return top;
+      } else {
+        current = current->parent;
+        copy = copy->parent;
+      }
+    }
+  }
+
+  struct SubtreeTask {
+    const Node *source;
+    Node *parent;
+    bool toLeft;
+  };
+
+  static Node *copyTop(const Node *source, Node *parent, int levels,
+                       std::vector<SubtreeTask> &tasks) {
+    Node *copy = cloneNode(source, parent);
+    if (source->left != nullptr) {
+      if (levels > 1) {
+        copy->left = copyTop(source->left, copy, levels - 1, tasks);
+      } else {
+        tasks.push_back({source->left, copy, true});
+      }
+    }
+    if (source->right != nullptr) {
+      if (levels > 1) {
+        copy->right = copyTop(source->right, copy, levels - 1, tasks);
+      } else {
+        tasks.push_back({source->right, copy, false});
+      }
+    }
+    return copy;
+  }
+
+  // Fork-join copy: the top levels are cloned here, each subtree below them
+  // by its own task.
+  static Node *copyNodes(const Node *source, size_type count) {
+    unsigned threads = parallelTasks(count);
+    if (threads <= 1) return copySubtree(source, nullptr);
+    std::vector<SubtreeTask> tasks;
+    Node *top = copyTop(source, nullptr, splitLevels(threads), tasks);
+    std::vector<std::future<Node *>> copies;
+    for (const SubtreeTask &task : tasks) {
+      copies.push_back(std::async(std::launch::async, copySubtree,
+                                  task.source, task.parent));
+    }
+    for (size_type i = 0; i < tasks.size(); ++i) {
+      Node *copy = copies[i].get();
+      (tasks[i].toLeft ? tasks[i].parent->left : tasks[i].parent->right) =
+          copy;
+    }
+    return top;
+  }
+
+  // Post-order teardown without recursion: descend to a leaf, cut it from
+  // its parent, free it and continue from the parent.
+  template <typename Free>
+  static void destroySubtree(Node *node, Free free) {
+    while (node != nullptr) {
+      if (node->left != nullptr) {
+        node = node->left;
+      } else if (node->right != nullptr) {
+        node = node->right;
+      } else {
+        Node *parent = node->parent;
+        if (parent != nullptr) {
+          (parent->left == node ? parent->left : parent->right) = nullptr;
+        }
+        free(node);
+        node = parent;
+      }
+    }
+  }
+
+  static void deleteSubtree(Node *node) {
+    destroySubtree(node, [](Node *n) { delete n; });
+  }
+
+  // Fork-join teardown: the subtrees below the top levels are detached and
+  // freed by separate tasks, the top levels on the calling thread.
+  static void deleteNodes(Node *top, size_type count) {
+    unsigned threads = parallelTasks(count);
+    if (threads > 1) {
+      std::vector<Node *> subtrees;
+      collectAtDepth(top, splitLevels(threads), subtrees);
+      std::vector<std::future<void>> done;
+      for (Node *subtree : subtrees) {
+        Node *parent = subtree->parent;
+        (parent->left == subtree ? parent->left : parent->right) = nullptr;
+        subtree->parent = nullptr;
+        done.push_back(std::async(std::launch::async, deleteSubtree, subtree));
+      }
+      deleteSubtree(top);
+      for (auto &task : done) task.get();
+      return;
+    }
+    deleteSubtree(top);
+  }
+
+  void cancelCompaction() noexcept {
+    if (compaction == nullptr) return;
+    compaction->plan.clear();
+    compaction->plan.shrink_to_fit();
+    compaction->position = 0;
+    compaction->arena.closeBlock();
+    dropEmptyCompaction();
+  }
+
+  void dropEmptyCompaction() noexcept {
+    if (compaction->plan.empty() && compaction->arena.empty()) {
+      delete compaction;
+      compaction = nullptr;
+    }
+  }
+
+  // Moves a node into slot and repoints its neighbours at the new copy.
+  void relocate(Node *node, Node *slot) {
+    Node *moved = new (slot) Node(std::move(*node));
+    replaceChild(moved->parent, node, moved);
+    if (moved->left != nullptr) moved->left->parent = moved;
+    if (moved->right != nullptr) moved->right->parent = moved;
+    if constexpr (kThreaded) {
+      if (moved->prev != nullptr) moved->prev->next = moved;
+      if (moved->next != nullptr) moved->next->prev = moved;
+    }
+    freeNode(node);
+  }
+
+  static int subtreeHeight(const Node *node) {
+    if (node == nullptr) return 0;
+    return 1 + std::max(subtreeHeight(node->left), subtreeHeight(node->right));
+  }
+
+  // Lays out the top half of the levels recursively, then each subtree
+  // hanging below them, so every subtree occupies a contiguous range.
+  static void vanEmdeBoasOrder(Node *node, int height,
+                               std::vector<Node *> &out) {
+    if (node == nullptr) return;
+    if (height == 1) {
+      out.push_back(node);
+      return;
+    }
+    int top = height / 2;
+    vanEmdeBoasOrder(node, top, out);
+    std::vector<Node *> bottoms;
+    collectAtDepth(node, top, bottoms);
+    for (Node *bottom : bottoms) {
+      vanEmdeBoasOrder(bottom, height - top, out);
+    }
+  }
+
+  static void collectAtDepth(Node *node, int depth, std::vector<Node *> &out) {
+    if (node == nullptr) return;
+    if (depth == 0) {
+      out.push_back(node);
+      return;
+    }
+    collectAtDepth(node->left, depth - 1, out);
+    collectAtDepth(node->right, depth - 1, out);
+  }
+
+  // Climbs from the finger (a node whose key is below key) to the lowest
+  // ancestor whose subtree key range contains key; null starts at the root.
+  Node *fingerStart(Node *finger, const key_type &key,
+                    const prefix_type &prefix) const {
+    if (finger == nullptr) return root;
+    Node *current = finger;
+    while (true) {
+      while (current->parent != nullptr && current->parent->right == current) {
+        current = current->parent;
+      }
+      Node *parent = current->parent;
+      if (parent == nullptr || compareToNode(key, prefix, parent) < 0) {
+        return current;
+      }
+      current = parent;
+    }
+  }
+
+  template <typename Update>
+  void mergeRebuild(const std::vector<Update> &updates) {
+    cancelCompaction();
+    std::vector<Node *> current = inOrderNodes();
+    std::vector<Node *> nodes;
+    nodes.reserve(current.size() + updates.size());
+    auto n = current.begin();
+    auto update = updates.begin();
+    while (n != current.end() || update != updates.end()) {
+      int cmp = (n == current.end())         ? -1
+                : (update == updates.end()) ? 1
+                                              : threeWayCompare(
+                                                    keyOf(update->value),
+                                                    keyOf((*n)->data),
+                                                    this->keyCompare());
+      if (cmp > 0) {
+        nodes.push_back(*n++);
+        continue;
+      }
+      if (update->op == batch_op::insert) {
+        if (cmp == 0) {
+          (*n)->data = update->value;
+          nodes.push_back(*n);
+        } else {
+          nodes.push_back(newNode(update->value));
+        }
+      } else if (cmp == 0) {
+        freeNode(*n);
+        countEvent(&tree_counters::deallocations);
+      }
+      if (cmp == 0) ++n;
+      ++update;
+    }
+    rebuildFrom(nodes);
+  }
+
+  // Collected before any node is freed: moveForward climbs parent links.
+  std::vector<Node *> inOrderNodes() const {
+    std::vector<Node *> nodes;
+    if (empty()) return nodes;
+    nodes.reserve(size_);
+    for (Node *n = root->getMin(); n != nullptr; n = n->moveForward()) {
+      nodes.push_back(n);
+    }
+    return nodes;
+  }
+
+  // Links the in-order node sequence into a perfectly balanced tree.
+  void rebuildFrom(std::vector<Node *> &nodes) {
+    size_ = nodes.size();
+    if (nodes.empty()) {
+      root = nullptr;
+      return;
+    }
+    int maxDepth = 0;
+    while ((size_type(2) << maxDepth) - 1 < nodes.size()) ++maxDepth;
+    root = buildBalanced(nodes, 0, nodes.size(), nullptr, 0, maxDepth);
+    if constexpr (kThreaded) {
+      for (size_type i = 0; i < nodes.size(); ++i) {
+        nodes[i]->prev = (i > 0) ? nodes[i - 1] : nullptr;
+        nodes[i]->next = (i + 1 < nodes.size()) ? nodes[i + 1] : nullptr;
+      }
+    }
+  }
+
+  // Recomputes all threads from the links, e.g. after a structural copy.
+  void rethread() noexcept {
+    if constexpr (kThreaded) {
+      if (empty()) return;
+      Node *prev = nullptr;
+      for (Node *n = root->getMin(); n != nullptr; n = n->nextInTree()) {
+        n->prev = prev;
+        if (prev != nullptr) prev->next = n;
+        prev = n;
+      }
+      prev->next = nullptr;
+    }
+  }
+
+  Node *buildBalanced(std::vector<Node *> &nodes, size_type first,
+                      size_type last, Node *parent, int depth, int maxDepth) {
+    if (first == last) return nullptr;
+    size_type middle = first + (last - first) / 2;
+    Node *node = nodes[middle];
+    node->parent = parent;
+    node->left = buildBalanced(nodes, first, middle, node, depth + 1, maxDepth);
+    node->right =
+        buildBalanced(nodes, middle + 1, last, node, depth + 1, maxDepth);
+    if constexpr (IsAugmented<balance_>::value) {
+      balance_::afterBuild(*this, node, depth, maxDepth);
+    } else {
+      balance_::afterBuild(node, depth, maxDepth);
+    }
+    return node;
+  }
+
+  template <typename K>
+  static prefix_type makePrefix(const K &key) {
+    if constexpr (std::is_same<K, key_type>::value) {
+      return prefix_type(key);
+    } else {
+      return prefix_type();
+    }
+  }
+
+  // The cached prefix is only meaningful when the probe is a key_type; other
+  // (transparent) probe types always go through the comparator.
+  template <typename K>
+  int compareToNode(const K &key, const prefix_type &prefix,
+                    const Node *n) const {
+    countEvent(&tree_counters::comparisons);
+    if constexpr (prefix_type::enabled && std::is_same<K, key_type>::value) {
+      int cmp = prefix.compare(*n);
+      return (cmp != 0) ? cmp : prefix_type::compareRest(key, keyOf(n->data));
+    } else {
+      (void)prefix;
+      return threeWayCompare(key, keyOf(n->data), this->keyCompare());
+    }
+  }
+
+  // First node whose key is not less than (upper == false) or greater than
+  // (upper == true) the given key.
+  template <typename K>
+  Node *boundNode(const K &key, bool upper) const {
+    if (empty()) return nullptr;
+    prefix_type prefix = makePrefix(key);
+    Node *current = root;
+    Node *result = nullptr;
+    while (current != nullptr) {
+      int cmp = compareToNode(key, prefix, current);
+      if (cmp < 0 || (cmp == 0 && !upper)) {
+        result = current;
+        current = current->left;
+      } else {
+        current = current->right;
+      }
+    }
+    return result;
+  }
+
+  // Summary of the keys between the bounds; a null bound is open-ended. The
+  // lower bound is inclusive or exclusive, the upper one always exclusive.
+  template <typename K>
+  auto aggregateRange(const K *lo, bool loInclusive, const K *hi) const {
+    using augment = typename balance_::augment_type;
+    typename augment::summary_type result = augment::identity();
+    if (empty()) return result;
+    prefix_type loPrefix = lo ? makePrefix(*lo) : prefix_type();
+    prefix_type hiPrefix = hi ? makePrefix(*hi) : prefix_type();
+    auto belowLo = [&](const Node *n) {
+      if (lo == nullptr) return false;
+      int cmp = compareToNode(*lo, loPrefix, n);
+      return loInclusive ? cmp > 0 : cmp >= 0;
+    };
+    auto reachesHi = [&](const Node *n) {
+      return hi != nullptr && compareToNode(*hi, hiPrefix, n) <= 0;
+    };
+    Node *split = root;
+    while (split != nullptr) {
+      if (belowLo(split)) {
+        split = split->right;
+      } else if (reachesHi(split)) {
+        split = split->left;
+      } else {
+        break;
+      }
+    }
+    if (split == nullptr) return result;
+    for (Node *n = split->left; n != nullptr;) {
+      if (belowLo(n)) {
+        n = n->right;
+        continue;
+      }
+      if (n->right != nullptr) {
+        result = balance_::join(*this, n->right->fields.summary, result);
+      }
+      result = balance_::join(*this, augment::of(n->data), result);
+      n = n->left;
+    }
+    result = balance_::join(*this, result, augment::of(split->data));
+    for (Node *n = split->right; n != nullptr;) {
+      if (reachesHi(n)) {
+        n = n->left;
+        continue;
+      }
+      if (n->left != nullptr) {
+        result = balance_::join(*this, result, n->left->fields.summary);
+      }
+      result = balance_::join(*this, result, augment::of(n->data));
+      n = n->right;
+    }
+    return result;
+  }
+
+  // node spans exactly the keys strictly between lo and hi (null bounds are
+  // open-ended); other is compared over the same range.
+  template <typename Fn>
+  void diffSubtree(const Node *node, const key_type *lo, const key_type *hi,
+                   const BinaryTree &other, Fn &fn) const {
+    using augment = typename balance_::augment_type;
+    while (true) {
+      auto theirs = other.aggregateRange(lo, false, hi);
+      if (node == nullptr) {
+        if (theirs == augment::identity()) return;
+        Node *n = lo ? other.boundNode(*lo, true) : other.minNode();
+        prefix_type hiPrefix = hi ? makePrefix(*hi) : prefix_type();
+        for (; n != nullptr; n = n->moveForward()) {
+          if (hi != nullptr && other.compareToNode(*hi, hiPrefix, n) <= 0) {
+            break;
+          }
+          fn(static_cast<const value_type *>(nullptr),
+             static_cast<const value_type *>(&n->data));
+        }
+        return;
+      }
+      if (node->fields.summary == theirs) return;
+      const key_type &key = keyOf(node->data);
+      const Node *match = other.search(key);
+      if (match == nullptr || !(match->data == node->data)) {
+        fn(static_cast<const value_type *>(&node->data),
+           match ? static_cast<const value_type *>(&match->data) : nullptr);
+      }
+      diffSubtree(node->left, lo, &key, other, fn);
+      node = node->right;
+      lo = &key;
+    }
+  }
+
+  // Allocated by a compaction and freed once its arena holds no nodes; the
+  // arena owns the relocated nodes.
+  struct Compaction {
+    NodeArena<Node> arena;
+    std::vector<Node *> plan;
+    size_type position = 0;
+  };
+
   Node *root;
   size_type size_;
-  compare_ compare_Keys;
+  Compaction *compaction = nullptr;
 };
 
-template <typename key_, typename value_, typename compare_>
-class BinaryTree<key_, value_, compare_>::Node {
+template <typename key_, typename value_, typename compare_,
+          typename balance_>
+class BinaryTree<key_, value_, compare_, balance_>::Node
+    : public prefix_type,
+      public ThreadLinks<Node, kThreaded> {
  public:
   Node() = default;
-  Node(value_type data_) : data(data_) {}
-
-  Node *copyNode(const Node *other) {
-    Node *copy = new Node{other->data};
-    if (other->left) copy->left = copy->copyNode(other->left);
-    if (other->right) copy->right = copy->copyNode(other->right);
-    copy->parent = this;
-    return copy;
+  Node(value_type data_) : prefix_type(makePrefix(keyOf(data_))), data(data_) {}
+  template <typename Make>
+  Node(EmplaceTag, Make &make) : data(make()) {
+    static_cast<prefix_type &>(*this) = makePrefix(keyOf(data));
   }
 
   Node *moveForward() const {
+    if constexpr (kThreaded) {
+      return this->next;
+    } else {
+      return nextInTree();
+    }
+  }
+
+  Node *moveBack() const {
+    if constexpr (kThreaded) {
+      return this->prev;
+    } else {
+      return prevInTree();
+    }
+  }
+
+  // Successor and predecessor found through the tree links alone.
+  Node *nextInTree() const {
     Node *p = const_cast<Node *>(this);
     if (right != nullptr) {
       return right->getMin();
@@ -407,7 +1456,7 @@ class BinaryTree<key_, value_, compare_>::Node {
     return p;
   }
 
-  Node *moveBack() const {
+  Node *prevInTree() const {
     Node *p = const_cast<Node *>(this);
     if (left != nullptr) {
       return left->getMax();
@@ -417,7 +1466,7 @@ class BinaryTree<key_, value_, compare_>::Node {
         p = tempParent;
         tempParent = tempParent->parent;
       }
-      p = parent;
+      p = tempParent;
     }
     return p;
   }
@@ -432,54 +1481,11 @@ class BinaryTree<key_, value_, compare_>::Node {
     return right->getMax();
   }
 
-  int updateHeight() {
-    int left_height = (left == nullptr) ? 0 : left->updateHeight();
-    int right_height = (right == nullptr) ? 0 : right->updateHeight();
-    height = 1 + std::max(left_height, right_height);
-    return height;
-  }
-
-  int getHeight() const { return (this != nullptr) ? height : 0; }
-
-  int bfactor() const { return right->getHeight() - left->getHeight(); }
-
-  Node *search(const key_ &key) {
-    if (data < key) {
-      return (right == nullptr) ? nullptr : right->search(key);
-    } else if (data > key) {
-      return (left == nullptr) ? nullptr : left->search(key);
-    } else {
-      return this;
-    }
-  }
-
-  size_type countNonUnique(const key_ &key) const noexcept {
-    size_type count_left = (left == nullptr) ? 0 : left->countNonUnique(key);
-    size_type count_right = (right == nullptr) ? 0 : right->countNonUnique(key);
-    return (data == key ? 1 : 0) + count_left + count_right;
-  }
-
-  Node *getPair(const key_ &key) {
-    Node *left_res = (left == nullptr) ? nullptr : left->getPair(key);
-    Node *right_res = (right == nullptr) ? nullptr : right->getPair(key);
-    if (data.first == key) return this;
-    return (data.first < key) ? right_res : left_res;
-  }
-
-  void clearNode(Node *node) {
-    if (node != nullptr) {
-      clearNode(node->left);
-      clearNode(node->right);
-      delete node;
-      node = nullptr;
-    }
-  }
-
   value_type data;
   Node *left = nullptr;
   Node *right = nullptr;
   Node *parent = nullptr;
-  int height = 0;
+  balance_fields fields;
 };
 }  // namespace s21
 
@@ -0,0 +1,672 @@
+#ifndef S21_CONTAINERS_BITMAP_SET_H
+#define S21_CONTAINERS_BITMAP_SET_H
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+// Ordered set of 32-bit unsigned integers stored as a roaring bitmap: values
+// are split by their high 16 bits into chunks, and every chunk keeps its low
+// 16 bits in whichever container is smallest for its contents (a sorted
+// array, a 65536-bit bitmap or a list of runs).
+class bitmap_set {
+ public:
+  using key_type = std::uint32_t;
+  using value_type = std::uint32_t;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using size_type = std::size_t;
+
+  class bitmapIterator;
+  using iterator = bitmapIterator;
+  using const_iterator = bitmapIterator;
+
+  bitmap_set() = default;
+
+  bitmap_set(std::initializer_list<value_type> const &items) {
+    for (auto item : items) insert(item);
+  }
+
+  bitmap_set(const bitmap_set &other) = default;
+  bitmap_set(bitmap_set &&other) noexcept = default;
+  bitmap_set &operator=(const bitmap_set &other) = default;
+  bitmap_set &operator=(bitmap_set &&other) noexcept = default;
+  ~bitmap_set() = default;
+
+  bool empty() const noexcept { return chunks_.empty(); }
+
+  // O(number of chunks): every chunk keeps its own cardinality.
+  size_type size() const noexcept {
+    size_type result = 0;
+    for (const auto &chunk : chunks_) result += chunk.cardinality;
+    return result;
+  }
+
+  size_type max_size() const noexcept {
+    return size_type(std::numeric_limits<value_type>::max()) + 1;
+  }
+
+  iterator begin() const noexcept { return iterator(this, 0); }
+
+  iterator end() const noexcept { return iterator(this, chunks_.size()); }
+
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  const_iterator cend() const noexcept { return end(); }
+
+  std::pair<iterator, bool> insert(value_type value) {
+    size_type index = lowerChunk(high(value));
+    if (index == chunks_.size() || chunks_[index].key != high(value)) {
+      chunks_.insert(chunks_.begin() + index, Chunk(high(value)));
+    }
+    bool inserted = chunks_[index].add(low(value));
+    return {iterator(this, index, low(value)), inserted};
+  }
+
+  void erase(iterator pos) {
+    if (pos == end()) throw std::out_of_range("erase of end iterator");
+    erase(*pos);
+  }
+
+  size_type erase(value_type value) {
+    size_type index = lowerChunk(high(value));
+    if (index == chunks_.size() || chunks_[index].key != high(value)) return 0;
+    if (!chunks_[index].remove(low(value))) return 0;
+    if (chunks_[index].cardinality == 0) {
+      chunks_.erase(chunks_.begin() + index);
+    }
+    return 1;
+  }
+
+  void clear() noexcept { chunks_.clear(); }
+
+  void swap(bitmap_set &other) noexcept { chunks_.swap(other.chunks_); }
+
+  void merge(bitmap_set &other) {
+    *this |= other;
+    other.clear();
+  }
+
+  bool contains(value_type value) const noexcept {
+    size_type index = lowerChunk(high(value));
+    return index != chunks_.size() && chunks_[index].key == high(value) &&
+           chunks_[index].contains(low(value));
+  }
+
+  iterator find(value_type value) const noexcept {
+    if (!contains(value)) return end();
+    return iterator(this, lowerChunk(high(value)), low(value));
+  }
+
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    std::vector<std::pair<iterator, bool>> result;
+    std::vector<value_type> arguments = {
+        static_cast<value_type>(std::forward<Args>(args))...};
+    for (auto &elem : arguments) result.push_back(insert(elem));
+    return result;
+  }
+
+  // Converts every chunk to run containers where that is smaller; useful once
+  // a set has been filled with long consecutive ranges.
+  void run_optimize() {
+    for (auto &chunk : chunks_) chunk.optimize();
+  }
+
+  bitmap_set &operator|=(const bitmap_set &other) {
+    return *this = combine(*this, other, Op::kUnion);
+  }
+
+  bitmap_set &operator&=(const bitmap_set &other) {
+    return *this = combine(*this, other, Op::kIntersection);
+  }
+
+  bitmap_set &operator-=(const bitmap_set &other) {
+    return *this = combine(*this, other, Op::kDifference);
+  }
+
+  friend bitmap_set operator|(const bitmap_set &a, const bitmap_set &b) {
+    return combine(a, b, Op::kUnion);
+  }
+
+  friend bitmap_set operator&(const bitmap_set &a, const bitmap_set &b) {
+    return combine(a, b, Op::kIntersection);
+  }
+
+  friend bitmap_set operator-(const bitmap_set &a, const bitmap_set &b) {
+    return combine(a, b, Op::kDifference);
+  }
+
+  bool operator==(const bitmap_set &other) const {
+    if (chunks_.size() != other.chunks_.size()) return false;
+    for (size_type i = 0; i < chunks_.size(); ++i) {
+      if (!chunks_[i].sameValues(other.chunks_[i])) return false;
+    }
+    return true;
+  }
+
+  bool operator!=(const bitmap_set &other) const { return !(*this == other); }
+
+  // Portable little-endian image: "S21B", chunk count, then for every chunk
+  // its key, container kind, cardinality and payload.
+  std::vector<std::uint8_t> serialize() const {
+    std::vector<std::uint8_t> out = {'S', '2', '1', 'B'};
+    putInt(out, std::uint32_t(chunks_.size()), 4);
+    for (const auto &chunk : chunks_) {
+      putInt(out, chunk.key, 2);
+      out.push_back(std::uint8_t(chunk.kind));
+      putInt(out, chunk.cardinality, 4);
+      if (chunk.kind == Kind::kArray) {
+        for (auto v : chunk.array) putInt(out, v, 2);
+      } else if (chunk.kind == Kind::kBitmap) {
+        for (auto w : chunk.bitmap) putInt(out, w, 8);
+      } else {
+        putInt(out, std::uint32_t(chunk.runs.size()), 4);
+        for (const auto &run : chunk.runs) {
+          putInt(out, run.start, 2);
+          putInt(out, run.length, 2);
+        }
+      }
+    }
+    return out;
+  }
+
+  static bitmap_set deserialize(const std::vector<std::uint8_t> &in) {
+    size_type pos = 0;
+    if (in.size() < 8 || in[0] != 'S' || in[1] != '2' || in[2] != '1' ||
+        in[3] != 'B') {
+      throw std::invalid_argument("not a serialized bitmap_set");
+    }
+    pos = 4;
+    bitmap_set result;
+    std::uint32_t count = std::uint32_t(getInt(in, pos, 4));
+    for (std::uint32_t i = 0; i < count; ++i) {
+      Chunk chunk(std::uint16_t(getInt(in, pos, 2)));
+      if (pos >= in.size()) throw std::invalid_argument("truncated bitmap_set");
+      std::uint8_t kind = in[pos++];
+      chunk.cardinality = std::uint32_t(getInt(in, pos, 4));
+      if (kind == std::uint8_t(Kind::kArray)) {
+        requireBytes(in, pos, size_type(chunk.cardinality) * 2);
+        chunk.array.resize(chunk.cardinality);
+        for (auto &v : chunk.array) v = std::uint16_t(getInt(in, pos, 2));
+      } else if (kind == std::uint8_t(Kind::kBitmap)) {
+        chunk.toKind(Kind::kBitmap);
+        for (auto &w : chunk.bitmap) w = getInt(in, pos, 8);
+      } else if (kind == std::uint8_t(Kind::kRun)) {
+        chunk.kind = Kind::kRun;
+        std::uint32_t runCount = std::uint32_t(getInt(in, pos, 4));
+        requireBytes(in, pos, size_type(runCount) * 4);
+        chunk.runs.resize(runCount);
+        for (auto &run : chunk.runs) {
+          run.start = std::uint16_t(getInt(in, pos, 2));
+          run.length = std::uint16_t(getInt(in, pos, 2));
+        }
+      } else {
+        throw std::invalid_argument("unknown bitmap_set container kind");
+      }
+      if (!chunk.ordered() || chunk.countValues() != chunk.cardinality ||
+          chunk.cardinality == 0 ||
+          (!result.chunks_.empty() && result.chunks_.back().key >= chunk.key)) {
+        throw std::invalid_argument("corrupted bitmap_set");
+      }
+      result.chunks_.push_back(std::move(chunk));
+    }
+    return result;
+  }
+
+ private:
+  enum class Kind : std::uint8_t { kArray = 0, kBitmap = 1, kRun = 2 };
+  enum class Op { kUnion, kIntersection, kDifference };
+
+  static constexpr std::uint32_t kArrayMax = 4096;
+  static constexpr std::size_t kBitmapWords = 1024;
+
+  // Inclusive run [start, start + length].
+  struct Run {
+    std::uint16_t start;
+    std::uint16_t length;
+    std::uint32_t last() const noexcept { return std::uint32_t(start) + length; }
+  };
+
+  struct Chunk {
+    explicit Chunk(std::uint16_t key_) : key(key_) {}
+
+    bool contains(std::uint16_t v) const noexcept {
+      if (kind == Kind::kArray) {
+        return std::binary_search(array.begin(), array.end(), v);
+      } else if (kind == Kind::kBitmap) {
+        return (bitmap[v >> 6] >> (v & 63)) & 1;
+      }
+      size_type i = runIndex(v);
+      return i < runs.size() && runs[i].start <= v && v <= runs[i].last();
+    }
+
+    bool add(std::uint16_t v) {
+      bool added = false;
+      if (kind == Kind::kArray) {
+        auto it = std::lower_bound(array.begin(), array.end(), v);
+        if (it == array.end() || *it != v) {
+          array.insert(it, v);
+          added = true;
+        }
+      } else if (kind == Kind::kBitmap) {
+        std::uint64_t mask = std::uint64_t(1) << (v & 63);
+        added = !(bitmap[v >> 6] & mask);
+        bitmap[v >> 6] |= mask;
+      } else {
+        added = addToRuns(v);
+      }
+      if (added) ++cardinality;
+      if (kind == Kind::kArray && cardinality > kArrayMax) toKind(Kind::kBitmap);
+      return added;
+    }
+
+    bool remove(std::uint16_t v) {
+      bool removed = false;
+      if (kind == Kind::kArray) {
+        auto it = std::lower_bound(array.begin(), array.end(), v);
+        if (it != array.end() && *it == v) {
+          array.erase(it);
+          removed = true;
+        }
+      } else if (kind == Kind::kBitmap) {
+        std::uint64_t mask = std::uint64_t(1) << (v & 63);
+        removed = bitmap[v >> 6] & mask;
+        bitmap[v >> 6] &= ~mask;
+      } else {
+        removed = removeFromRuns(v);
+      }
+      if (removed) --cardinality;
+      if (kind == Kind::kBitmap && cardinality <= kArrayMax) {
+        toKind(Kind::kArray);
+      }
+      return removed;
+    }
+
+    // Index of the last run starting at or before v, or runs.size().
+    size_type runIndex(std::uint16_t v) const noexcept {
+      auto it = std::upper_bound(
+          runs.begin(), runs.end(), v,
+          [](std::uint16_t value, const Run &run) { return value < run.start; });
+      return it == runs.begin() ? runs.size() : size_type(it - runs.begin()) - 1;
+    }
+
+    bool addToRuns(std::uint16_t v) {
+      size_type i = runIndex(v);
+      if (i < runs.size() && v <= runs[i].last()) return false;
+      bool joinsLeft = i < runs.size() && runs[i].last() + 1 == v;
+      size_type next = (i < runs.size()) ? i + 1 : 0;
+      bool joinsRight = next < runs.size() && runs[next].start == v + 1u;
+      if (joinsLeft && joinsRight) {
+        runs[i].length = std::uint16_t(runs[next].last() - runs[i].start);
+        runs.erase(runs.begin() + next);
+      } else if (joinsLeft) {
+        ++runs[i].length;
+      } else if (joinsRight) {
+        --runs[next].start;
+        ++runs[next].length;
+      } else {
+        runs.insert(runs.begin() + next, Run{v, 0});
+      }
+      return true;
+    }
+
+    bool removeFromRuns(std::uint16_t v) {
+      size_type i = runIndex(v);
+      if (i == runs.size() || v > runs[i].last()) return false;
+      Run run = runs[i];
+      if (run.length == 0) {
+        runs.erase(runs.begin() + i);
+      } else if (v == run.start) {
+        ++runs[i].start;
+        --runs[i].length;
+      } else if (v == run.last()) {
+        --runs[i].length;
+      } else {
+        runs[i].length = std::uint16_t(v - run.start - 1);
+        runs.insert(runs.begin() + i + 1,
+                    Run{std::uint16_t(v + 1),
+                        std::uint16_t(run.last() - v - 1)});
+      }
+      return true;
+    }
+
+    std::uint32_t countValues() const noexcept {
+      std::uint32_t count = 0;
+      if (kind == Kind::kArray) {
+        count = std::uint32_t(array.size());
+      } else if (kind == Kind::kBitmap) {
+        for (auto w : bitmap) count += std::uint32_t(__builtin_popcountll(w));
+      } else {
+        for (const auto &run : runs) count += run.length + 1u;
+      }
+      return count;
+    }
+
+    bool ordered() const noexcept {
+      for (size_type i = 1; i < array.size(); ++i) {
+        if (array[i - 1] >= array[i]) return false;
+      }
+      for (size_type i = 0; i < runs.size(); ++i) {
+        if (runs[i].last() > 0xFFFF) return false;
+        if (i > 0 && runs[i - 1].last() + 1 >= runs[i].start) return false;
+      }
+      return true;
+    }
+
+    // Returns the smallest stored value >= v, or 65536 if none.
+    std::uint32_t nextValue(std::uint32_t v) const noexcept {
+      if (v > 0xFFFF) return 0x10000;
+      if (kind == Kind::kArray) {
+        auto it = std::lower_bound(array.begin(), array.end(), v);
+        return it == array.end() ? 0x10000 : *it;
+      } else if (kind == Kind::kBitmap) {
+        size_type word = v >> 6;
+        std::uint64_t bits = bitmap[word] & (~std::uint64_t(0) << (v & 63));
+        while (bits == 0) {
+          if (++word == kBitmapWords) return 0x10000;
+          bits = bitmap[word];
+        }
+        return std::uint32_t(word * 64 + __builtin_ctzll(bits));
+      }
+      size_type i = runIndex(std::uint16_t(v));
+      if (i < runs.size() && v <= runs[i].last()) return v;
+      i = (i < runs.size()) ? i + 1 : 0;
+      return i < runs.size() ? runs[i].start : 0x10000;
+    }
+
+    // Returns the largest stored value <= v, or -1 if none.
+    std::int32_t prevValue(std::int32_t v) const noexcept {
+      if (v < 0) return -1;
+      if (kind == Kind::kArray) {
+        auto it = std::upper_bound(array.begin(), array.end(), v);
+        return it == array.begin() ? -1 : *(it - 1);
+      } else if (kind == Kind::kBitmap) {
+        std::int32_t word = v >> 6;
+        std::uint64_t bits =
+            bitmap[word] & (~std::uint64_t(0) >> (63 - (v & 63)));
+        while (bits == 0) {
+          if (--word < 0) return -1;
+          bits = bitmap[word];
+        }
+        return word * 64 + 63 - __builtin_clzll(bits);
+      }
+      size_type i = runIndex(std::uint16_t(v));
+      if (i == runs.size()) return -1;
+      return std::int32_t(std::min<std::uint32_t>(runs[i].last(), v));
+    }
+
+    void toKind(Kind target) {
+      if (target == kind) return;
+      std::vector<std::uint64_t> words(kBitmapWords, 0);
+      fillBitmap(words.data());
+      array.clear();
+      runs.clear();
+      bitmap.clear();
+      kind = target;
+      if (target == Kind::kBitmap) {
+        bitmap = std::move(words);
+      } else if (target == Kind::kArray) {
+        array.reserve(cardinality);
+        for (std::uint32_t w = 0; w < kBitmapWords; ++w) {
+          for (std::uint64_t bits = words[w]; bits; bits &= bits - 1) {
+            array.push_back(std::uint16_t(w * 64 + __builtin_ctzll(bits)));
+          }
+        }
+      } else {
+        for (std::uint32_t v = nextSet(words, 0); v < 0x10000;) {
+          std::uint32_t last = v;
+          while (last + 1 < 0x10000 && ((words[(last + 1) >> 6] >>
+                                         ((last + 1) & 63)) & 1)) {
+            ++last;
+          }
+          runs.push_back(Run{std::uint16_t(v), std::uint16_t(last - v)});
+          v = nextSet(words, last + 1);
+        }
+      }
+    }
+
+    static std::uint32_t nextSet(const std::vector<std::uint64_t> &words,
+                                 std::uint32_t v) noexcept {
+      while (v < 0x10000) {
+        std::uint64_t bits = words[v >> 6] & (~std::uint64_t(0) << (v & 63));
+        if (bits) return (v & ~63u) + std::uint32_t(__builtin_ctzll(bits));
+        v = (v & ~63u) + 64;
+      }
+      return 0x10000;
+    }
+
+    void fillBitmap(std::uint64_t *words) const noexcept {
+      if (kind == Kind::kBitmap) {
+        std::copy(bitmap.begin(), bitmap.end(), words);
+      } else if (kind == Kind::kArray) {
+        for (auto v : array) words[v >> 6] |= std::uint64_t(1) << (v & 63);
+      } else {
+        for (const auto &run : runs) {
+          for (std::uint32_t v = run.start; v <= run.last(); ++v) {
+            words[v >> 6] |= std::uint64_t(1) << (v & 63);
+          }
+        }
+      }
+    }
+
+    // Picks the container with the smallest serialized size.
+    void optimize() {
+      Kind dense = cardinality > kArrayMax ? Kind::kBitmap : Kind::kArray;
+      Chunk probe(*this);
+      probe.toKind(Kind::kRun);
+      size_type denseBytes =
+          dense == Kind::kBitmap ? kBitmapWords * 8 : cardinality * 2;
+      if (probe.runs.size() * 4 + 4 < denseBytes) {
+        *this = std::move(probe);
+      } else {
+        toKind(dense);
+      }
+    }
+
+    bool sameValues(const Chunk &other) const {
+      if (key != other.key || cardinality != other.cardinality) return false;
+      if (kind == Kind::kArray && other.kind == Kind::kArray) {
+        return array == other.array;
+      }
+      std::vector<std::uint64_t> a(kBitmapWords, 0), b(kBitmapWords, 0);
+      fillBitmap(a.data());
+      other.fillBitmap(b.data());
+      return a == b;
+    }
+
+    std::uint16_t key;
+    Kind kind = Kind::kArray;
+    std::uint32_t cardinality = 0;
+    std::vector<std::uint16_t> array;
+    std::vector<std::uint64_t> bitmap;
+    std::vector<Run> runs;
+  };
+
+  static std::uint16_t high(value_type v) noexcept {
+    return std::uint16_t(v >> 16);
+  }
+  static std::uint16_t low(value_type v) noexcept {
+    return std::uint16_t(v & 0xFFFF);
+  }
+
+  size_type lowerChunk(std::uint16_t key) const noexcept {
+    auto it = std::lower_bound(
+        chunks_.begin(), chunks_.end(), key,
+        [](const Chunk &chunk, std::uint16_t k) { return chunk.key < k; });
+    return size_type(it - chunks_.begin());
+  }
+
+  // Word-at-a-time loops over the 1024-word bitmaps; written branch-free so
+  // the compiler vectorizes them.
+  static std::uint32_t combineWords(std::uint64_t *a, const std::uint64_t *b,
+                                    Op op) noexcept {
+    std::uint32_t count = 0;
+    for (size_type i = 0; i < kBitmapWords; ++i) {
+      std::uint64_t w = op == Op::kUnion          ? a[i] | b[i]
+                        : op == Op::kIntersection ? a[i] & b[i]
+                                                  : a[i] & ~b[i];
+      a[i] = w;
+      count += std::uint32_t(__builtin_popcountll(w));
+    }
+    return count;
+  }
+
+  static Chunk combineChunks(const Chunk &a, const Chunk &b, Op op) {
+    Chunk result(a.key);
+    if (a.kind == Kind::kArray && b.kind == Kind::kArray) {
+      if (op == Op::kUnion) {
+        std::set_union(a.array.begin(), a.array.end(), b.array.begin(),
+                       b.array.end(), std::back_inserter(result.array));
+      } else if (op == Op::kIntersection) {
+        std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(),
+                              b.array.end(), std::back_inserter(result.array));
+      } else {
+        std::set_difference(a.array.begin(), a.array.end(), b.array.begin(),
+                            b.array.end(), std::back_inserter(result.array));
+      }
+      result.cardinality = std::uint32_t(result.array.size());
+      if (result.cardinality > kArrayMax) result.toKind(Kind::kBitmap);
+    } else if (a.kind == Kind::kArray && op != Op::kUnion) {
+      for (auto v : a.array) {
+        if (b.contains(v) == (op == Op::kIntersection)) result.array.push_back(v);
+      }
+      result.cardinality = std::uint32_t(result.array.size());
+    } else {
+      std::vector<std::uint64_t> left(kBitmapWords, 0), right(kBitmapWords, 0);
+      a.fillBitmap(left.data());
+      b.fillBitmap(right.data());
+      result.kind = Kind::kBitmap;
+      result.cardinality = combineWords(left.data(), right.data(), op);
+      result.bitmap = std::move(left);
+      if (result.cardinality <= kArrayMax) result.toKind(Kind::kArray);
+    }
+    if (a.kind == Kind::kRun && b.kind == Kind::kRun) result.optimize();
+    return result;
+  }
+
+  static bitmap_set combine(const bitmap_set &a, const bitmap_set &b, Op op) {
+    bitmap_set result;
+    size_type i = 0, j = 0;
+    while (i < a.chunks_.size() || j < b.chunks_.size()) {
+      bool takeA = j == b.chunks_.size() ||
+                   (i < a.chunks_.size() && a.chunks_[i].key < b.chunks_[j].key);
+      bool takeB = i == a.chunks_.size() ||
+                   (j < b.chunks_.size() && b.chunks_[j].key < a.chunks_[i].key);
+      if (takeA) {
+        if (op != Op::kIntersection) result.chunks_.push_back(a.chunks_[i]);
+        ++i;
+      } else if (takeB) {
+        if (op == Op::kUnion) result.chunks_.push_back(b.chunks_[j]);
+        ++j;
+      } else {
+        Chunk chunk = combineChunks(a.chunks_[i++], b.chunks_[j++], op);
+        if (chunk.cardinality != 0) result.chunks_.push_back(std::move(chunk));
+      }
+    }
+    return result;
+  }
+
+  static void putInt(std::vector<std::uint8_t> &out, std::uint64_t value,
+                     int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(std::uint8_t(value >> (8 * i)));
+  }
+
+  static void requireBytes(const std::vector<std::uint8_t> &in, size_type pos,
+                           size_type bytes) {
+    if (in.size() - pos < bytes) {
+      throw std::invalid_argument("truncated bitmap_set");
+    }
+  }
+
+  static std::uint64_t getInt(const std::vector<std::uint8_t> &in,
+                              size_type &pos, int bytes) {
+    requireBytes(in, pos, size_type(bytes));
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) value |= std::uint64_t(in[pos++]) << (8 * i);
+    return value;
+  }
+
+  std::vector<Chunk> chunks_;
+
+ public:
+  class bitmapIterator {
+   public:
+    bitmapIterator() = delete;
+    bitmapIterator(const bitmap_set *set, size_type chunk,
+                   std::uint32_t low = 0)
+        : set_(set), chunk_(chunk), low_(low) {
+      settle();
+    }
+
+    value_type operator*() const noexcept {
+      return (value_type(set_->chunks_[chunk_].key) << 16) | low_;
+    }
+
+    bitmapIterator &operator++() {
+      ++low_;
+      settle();
+      return *this;
+    }
+
+    bitmapIterator operator++(int) {
+      bitmapIterator copy(*this);
+      ++*this;
+      return copy;
+    }
+
+    bitmapIterator &operator--() {
+      std::int32_t prev = -1;
+      if (chunk_ < set_->chunks_.size()) {
+        prev = set_->chunks_[chunk_].prevValue(std::int32_t(low_) - 1);
+      }
+      while (prev < 0 && chunk_ > 0) {
+        --chunk_;
+        prev = set_->chunks_[chunk_].prevValue(0xFFFF);
+      }
+      low_ = std::uint32_t(prev);
+      return *this;
+    }
+
+    bitmapIterator operator--(int) {
+      bitmapIterator copy(*this);
+      --*this;
+      return copy;
+    }
+
+    bool operator==(const bitmapIterator &other) const noexcept {
+      return chunk_ == other.chunk_ && low_ == other.low_;
+    }
+
+    bool operator!=(const bitmapIterator &other) const noexcept {
+      return !(*this == other);
+    }
+
+   private:
+    // Moves forward to the first stored value at or after the current
+    // position; the end iterator is (chunks_.size(), 0).
+    void settle() noexcept {
+      while (chunk_ < set_->chunks_.size()) {
+        low_ = set_->chunks_[chunk_].nextValue(low_);
+        if (low_ < 0x10000) return;
+        ++chunk_;
+        low_ = 0;
+      }
+      low_ = 0;
+    }
+
+    const bitmap_set *set_;
+    size_type chunk_;
+    std::uint32_t low_;
+  };
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_BITMAP_SET_H
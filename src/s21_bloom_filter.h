@@ -0,0 +1,158 @@
+#ifndef S21_CONTAINERS_BLOOM_FILTER_H
+#define S21_CONTAINERS_BLOOM_FILTER_H
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+template <typename Key, typename Hash, typename = void>
+struct IsHashable : std::false_type {};
+
+template <typename Key, typename Hash>
+struct IsHashable<Key, Hash,
+                  std::void_t<decltype(Hash()(std::declval<const Key &>()))>>
+    : std::true_type {};
+
+// Split-block Bloom filter: every key maps to one 64-byte block and sets one
+// bit in each of the block's eight words, so a probe touches a single cache
+// line and the eight word tests run as one vectorizable loop. Keys cannot be
+// removed; containers rebuild the filter from their contents instead.
+template <typename Key, typename Hash = std::hash<Key>>
+class BloomFilter {
+ public:
+  using size_type = std::size_t;
+
+  struct Stats {
+    size_type lookups = 0;
+    size_type filtered = 0;
+    size_type false_positives = 0;
+  };
+
+  BloomFilter(size_type capacity, double fpRate)
+      : capacity_(capacity < 64 ? 64 : capacity), fpRate_(fpRate) {
+    if (!(fpRate > 0.0 && fpRate < 1.0)) {
+      throw std::invalid_argument("false positive rate must be in (0, 1)");
+    }
+    double bits = double(capacity_) * bitsPerKey(fpRate);
+    blocks_.resize(size_type(std::ceil(bits / 512.0)));
+  }
+
+  void insert(const Key &key) noexcept {
+    std::uint64_t h = hash(key);
+    Block &block = blocks_[blockIndex(h)];
+    for (int i = 0; i < 8; ++i) block.words[i] |= bitFor(h, i);
+    ++inserted_;
+  }
+
+  bool mayContain(const Key &key) const noexcept {
+    std::uint64_t h = hash(key);
+    const Block &block = blocks_[blockIndex(h)];
+    std::uint64_t missing = 0;
+    for (int i = 0; i < 8; ++i) missing |= bitFor(h, i) & ~block.words[i];
+    return missing == 0;
+  }
+
+  // Lookup front used by the containers: counts the probe and returns false
+  // when the key is certainly absent.
+  bool admit(const Key &key) const noexcept {
+    ++stats_.lookups;
+    if (mayContain(key)) return true;
+    ++stats_.filtered;
+    return false;
+  }
+
+  void recordResult(bool found) const noexcept {
+    if (!found) ++stats_.false_positives;
+  }
+
+  void noteErase(size_type count = 1) noexcept { erased_ += count; }
+
+  void clear() noexcept {
+    for (auto &block : blocks_) block = Block{};
+    inserted_ = 0;
+    erased_ = 0;
+  }
+
+  // More keys than the filter was sized for: the false-positive rate is
+  // above target until the owner rebuilds it with a larger capacity.
+  bool overloaded() const noexcept { return inserted_ > capacity_; }
+
+  size_type capacity() const noexcept { return capacity_; }
+  size_type inserted() const noexcept { return inserted_; }
+  size_type erased() const noexcept { return erased_; }
+  double fp_rate() const noexcept { return fpRate_; }
+  const Stats &stats() const noexcept { return stats_; }
+  void setStats(const Stats &stats) noexcept { stats_ = stats; }
+
+ private:
+  struct alignas(64) Block {
+    std::uint64_t words[8] = {};
+  };
+
+  static std::uint64_t mix(std::uint64_t h) noexcept {
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+  }
+
+  // Containers instantiate the filter for every key type; only hashable
+  // keys can actually enable one.
+  static std::uint64_t hash(const Key &key) noexcept {
+    if constexpr (IsHashable<Key, Hash>::value) {
+      return mix(std::uint64_t(Hash()(key)));
+    } else {
+      (void)key;
+      return 0;
+    }
+  }
+
+  size_type blockIndex(std::uint64_t h) const noexcept {
+    return size_type(((h >> 32) * blocks_.size()) >> 32);
+  }
+
+  static std::uint64_t bitFor(std::uint64_t h, int word) noexcept {
+    static constexpr std::uint32_t kSalt[8] = {
+        0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+        0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+    return std::uint64_t(1) << ((std::uint32_t(h) * kSalt[word]) >> 26);
+  }
+
+  // Smallest bits-per-key whose expected false-positive rate meets the
+  // target, accounting for the uneven (Poisson) load of 512-bit blocks.
+  static double bitsPerKey(double fpRate) {
+    for (double bits = 4.0; bits < 64.0; bits += 0.5) {
+      if (expectedFpRate(bits) <= fpRate) return bits;
+    }
+    return 64.0;
+  }
+
+  static double expectedFpRate(double bitsPerKey) {
+    double lambda = 512.0 / bitsPerKey;
+    double probability = std::exp(-lambda);
+    double result = 0.0;
+    for (int keys = 0; keys < int(lambda * 4) + 32; ++keys) {
+      if (keys > 0) probability *= lambda / keys;
+      double setBit = 1.0 - std::pow(1.0 - 1.0 / 64.0, keys);
+      result += probability * std::pow(setBit, 8);
+    }
+    return result;
+  }
+
+  std::vector<Block> blocks_;
+  size_type capacity_;
+  double fpRate_;
+  size_type inserted_ = 0;
+  size_type erased_ = 0;
+  mutable Stats stats_;
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_BLOOM_FILTER_H
@@ -0,0 +1,498 @@
+#ifndef S21_CONTAINERS_CACHE_H
+#define S21_CONTAINERS_CACHE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+// Doubly linked list threaded through the entries of a cache by slot
+// index, so linking and unlinking never allocate.
+struct CacheList {
+  static constexpr std::size_t kNone = std::size_t(-1);
+
+  std::size_t head = kNone;
+  std::size_t tail = kNone;
+  std::size_t size = 0;
+};
+
+// Replacement policies of s21::cache. Each keeps its lists in state and
+// its per-entry data in entry_fields, and is told when an entry is
+// inserted, hit or removed; victim() names the entry to evict.
+
+// Evicts the least recently used entry.
+struct lru_policy {
+  struct entry_fields {};
+
+  struct state {
+    CacheList recency;
+  };
+
+  template <typename Cache>
+  static void inserted(Cache &cache, std::size_t slot) {
+    cache.linkFront(cache.policyState().recency, slot);
+  }
+
+  template <typename Cache>
+  static void touched(Cache &cache, std::size_t slot) {
+    cache.unlink(cache.policyState().recency, slot);
+    cache.linkFront(cache.policyState().recency, slot);
+  }
+
+  template <typename Cache>
+  static void removed(Cache &cache, std::size_t slot) {
+    cache.unlink(cache.policyState().recency, slot);
+  }
+
+  template <typename Cache>
+  static std::size_t victim(Cache &cache) {
+    return cache.policyState().recency.tail;
+  }
+};
+
+// Evicts the least frequently used entry, the least recent among equals.
+// Entries sit in one recency list per use count, and counts saturate at
+// kMaxFrequency, so every operation is O(1).
+struct lfu_policy {
+  static constexpr std::size_t kMaxFrequency = 63;
+
+  struct entry_fields {
+    std::size_t frequency = 1;
+  };
+
+  struct state {
+    CacheList lists[kMaxFrequency + 1];
+    std::size_t minFrequency = 1;
+  };
+
+  template <typename Cache>
+  static void inserted(Cache &cache, std::size_t slot) {
+    state &s = cache.policyState();
+    cache.fieldsOf(slot).frequency = 1;
+    cache.linkFront(s.lists[1], slot);
+    s.minFrequency = 1;
+  }
+
+  template <typename Cache>
+  static void touched(Cache &cache, std::size_t slot) {
+    state &s = cache.policyState();
+    std::size_t &frequency = cache.fieldsOf(slot).frequency;
+    cache.unlink(s.lists[frequency], slot);
+    if (frequency < kMaxFrequency) {
+      if (s.lists[frequency].size == 0 && s.minFrequency == frequency) {
+        ++s.minFrequency;
+      }
+      ++frequency;
+    }
+    cache.linkFront(s.lists[frequency], slot);
+  }
+
+  template <typename Cache>
+  static void removed(Cache &cache, std::size_t slot) {
+    cache.unlink(cache.policyState().lists[cache.fieldsOf(slot).frequency],
+                 slot);
+  }
+
+  // An erase may have emptied the lowest list; the scan is bounded by
+  // kMaxFrequency.
+  template <typename Cache>
+  static std::size_t victim(Cache &cache) {
+    state &s = cache.policyState();
+    while (s.lists[s.minFrequency].size == 0) ++s.minFrequency;
+    return s.lists[s.minFrequency].tail;
+  }
+};
+
+// Segmented LRU, which resists scans: new entries go to a probation
+// segment and move to the protected one on their second use. Protected
+// entries pushed out by newer ones fall back to probation, and evictions
+// take the oldest probation entry first, so a one-pass scan over many
+// keys cannot flush the entries that are used repeatedly.
+struct slru_policy {
+  // Share of the capacity reserved for protected entries.
+  static constexpr std::size_t kProtectedPercent = 80;
+
+  struct entry_fields {
+    bool isProtected = false;
+  };
+
+  struct state {
+    CacheList probation;
+    CacheList protectedSegment;
+  };
+
+  template <typename Cache>
+  static void inserted(Cache &cache, std::size_t slot) {
+    cache.fieldsOf(slot).isProtected = false;
+    cache.linkFront(cache.policyState().probation, slot);
+  }
+
+  template <typename Cache>
+  static void touched(Cache &cache, std::size_t slot) {
+    state &s = cache.policyState();
+    bool &isProtected = cache.fieldsOf(slot).isProtected;
+    cache.unlink(isProtected ? s.protectedSegment : s.probation, slot);
+    isProtected = true;
+    cache.linkFront(s.protectedSegment, slot);
+    std::size_t limit = cache.capacity() * kProtectedPercent / 100;
+    if (s.protectedSegment.size > std::max<std::size_t>(limit, 1)) {
+      std::size_t demoted = s.protectedSegment.tail;
+      cache.unlink(s.protectedSegment, demoted);
+      cache.fieldsOf(demoted).isProtected = false;
+      cache.linkFront(s.probation, demoted);
+    }
+  }
+
+  template <typename Cache>
+  static void removed(Cache &cache, std::size_t slot) {
+    state &s = cache.policyState();
+    cache.unlink(cache.fieldsOf(slot).isProtected ? s.protectedSegment
+                                                  : s.probation,
+                 slot);
+  }
+
+  template <typename Cache>
+  static std::size_t victim(Cache &cache) {
+    state &s = cache.policyState();
+    return s.probation.size > 0 ? s.probation.tail : s.protectedSegment.tail;
+  }
+};
+
+// Fixed-capacity key-value cache with O(1) get, put and evict. Entries
+// live in one slot array allocated up front and are chained into the
+// policy's recency lists by index; an open-addressing hash index maps keys
+// to slots. Hits, updates and evictions therefore never allocate. The
+// eviction callback sees every entry removed to make room, not those
+// erased or cleared.
+template <typename Key, typename T, typename Policy = lru_policy,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class cache {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using size_type = std::size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using policy_type = Policy;
+  using entry_fields = typename Policy::entry_fields;
+  using policy_state = typename Policy::state;
+  using eviction_callback = std::function<void(const Key &, T &)>;
+
+  explicit cache(size_type capacity) : capacity_(capacity) {
+    if (capacity == 0) throw std::invalid_argument("cache capacity is 0");
+    size_type buckets = 1;
+    while (buckets < 2 * capacity) buckets *= 2;
+    index.assign(buckets, 0);
+    entries.reserve(capacity);
+  }
+
+  // Returns the value and marks it used, or nullptr on a miss.
+  T *get(const Key &key) {
+    size_type slot = lookup(key, hashOf(key));
+    if (slot == CacheList::kNone) return nullptr;
+    Policy::touched(*this, slot);
+    return &entries[slot].item->second;
+  }
+
+  // Lookups that leave the replacement order alone.
+  T *peek(const Key &key) {
+    size_type slot = lookup(key, hashOf(key));
+    return slot != CacheList::kNone ? &entries[slot].item->second : nullptr;
+  }
+
+  bool contains(const Key &key) const {
+    return lookup(key, hashOf(key)) != CacheList::kNone;
+  }
+
+  // Inserts or overwrites the value and marks it used; a full cache first
+  // evicts its policy's victim. Returns true when the key was new.
+  bool put(const Key &key, T value) {
+    std::uint64_t hash = hashOf(key);
+    size_type slot = lookup(key, hash);
+    if (slot != CacheList::kNone) {
+      entries[slot].item->second = std::move(value);
+      Policy::touched(*this, slot);
+      return false;
+    }
+    if (size_ == capacity_) {
+      slot = Policy::victim(*this);
+      Entry &entry = entries[slot];
+      if (onEvict) onEvict(entry.item->first, entry.item->second);
+      release(slot);
+    }
+    slot = acquire(key, std::move(value), hash);
+    Policy::inserted(*this, slot);
+    return true;
+  }
+
+  bool erase(const Key &key) {
+    size_type slot = lookup(key, hashOf(key));
+    if (slot == CacheList::kNone) return false;
+    release(slot);
+    return true;
+  }
+
+  // Keeps the slot array and index, so refilling allocates nothing.
+  void clear() {
+    entries.clear();
+    index.assign(index.size(), 0);
+    freeSlots = CacheList();
+    state = policy_state();
+    size_ = 0;
+  }
+
+  size_type size() const noexcept { return size_; }
+
+  size_type capacity() const noexcept { return capacity_; }
+
+  bool empty() const noexcept { return size_ == 0; }
+
+  void set_eviction_callback(eviction_callback callback) {
+    onEvict = std::move(callback);
+  }
+
+  // Hooks for the policies.
+  policy_state &policyState() noexcept { return state; }
+
+  entry_fields &fieldsOf(size_type slot) noexcept {
+    return entries[slot].fields;
+  }
+
+  void linkFront(CacheList &list, size_type slot) noexcept {
+    Entry &entry = entries[slot];
+    entry.prev = CacheList::kNone;
+    entry.next = list.head;
+    if (list.head != CacheList::kNone) entries[list.head].prev = slot;
+    list.head = slot;
+    if (list.tail == CacheList::kNone) list.tail = slot;
+    ++list.size;
+  }
+
+  void unlink(CacheList &list, size_type slot) noexcept {
+    Entry &entry = entries[slot];
+    if (entry.prev != CacheList::kNone) {
+      entries[entry.prev].next = entry.next;
+    } else {
+      list.head = entry.next;
+    }
+    if (entry.next != CacheList::kNone) {
+      entries[entry.next].prev = entry.prev;
+    } else {
+      list.tail = entry.prev;
+    }
+    --list.size;
+  }
+
+ private:
+  // A free slot holds no key or value, so erased and evicted elements are
+  // destroyed at once rather than when the slot is reused.
+  struct Entry {
+    std::optional<std::pair<Key, T>> item;
+    std::uint64_t hash;
+    size_type prev = CacheList::kNone;
+    size_type next = CacheList::kNone;
+    entry_fields fields;
+  };
+
+  static std::uint64_t hashOf(const Key &key) {
+    std::uint64_t x = std::uint64_t(Hash()(key));
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  size_type mask() const noexcept { return index.size() - 1; }
+
+  // Index cells hold slot + 1, so 0 marks a free cell.
+  size_type lookup(const Key &key, std::uint64_t hash) const {
+    for (size_type i = hash & mask(); index[i] != 0; i = (i + 1) & mask()) {
+      const Entry &entry = entries[index[i] - 1];
+      if (entry.hash == hash && KeyEqual()(entry.item->first, key)) {
+        return index[i] - 1;
+      }
+    }
+    return CacheList::kNone;
+  }
+
+  // Takes a freed slot, or a new one while the array is below capacity.
+  size_type acquire(const Key &key, T value, std::uint64_t hash) {
+    size_type slot;
+    if (freeSlots.head != CacheList::kNone) {
+      slot = freeSlots.head;
+      freeSlots.head = entries[slot].next;
+      --freeSlots.size;
+      Entry &entry = entries[slot];
+      entry.item.emplace(key, std::move(value));
+      entry.hash = hash;
+      entry.fields = entry_fields();
+    } else {
+      slot = entries.size();
+      entries.push_back(Entry{std::pair<Key, T>(key, std::move(value)), hash,
+                              CacheList::kNone, CacheList::kNone,
+                              entry_fields()});
+    }
+    size_type i = hash & mask();
+    while (index[i] != 0) i = (i + 1) & mask();
+    index[i] = slot + 1;
+    ++size_;
+    return slot;
+  }
+
+  // Unlinks the entry and deletes its index cell by shifting later cells
+  // of the probe run back, so lookups never meet tombstones.
+  void release(size_type slot) {
+    Policy::removed(*this, slot);
+    size_type i = entries[slot].hash & mask();
+    while (index[i] != slot + 1) i = (i + 1) & mask();
+    for (size_type j = (i + 1) & mask(); index[j] != 0; j = (j + 1) & mask()) {
+      size_type home = entries[index[j] - 1].hash & mask();
+      bool movable =
+          (j > i) ? (home <= i || home > j) : (home <= i && home > j);
+      if (movable) {
+        index[i] = index[j];
+        i = j;
+      }
+    }
+    index[i] = 0;
+    entries[slot].item.reset();
+    entries[slot].next = freeSlots.head;
+    freeSlots.head = slot;
+    ++freeSlots.size;
+    --size_;
+  }
+
+  std::vector<Entry> entries;
+  std::vector<size_type> index;
+  CacheList freeSlots;
+  policy_state state;
+  size_type capacity_;
+  size_type size_ = 0;
+  eviction_callback onEvict;
+};
+
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+using lru_cache = cache<Key, T, lru_policy, Hash, KeyEqual>;
+
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+using lfu_cache = cache<Key, T, lfu_policy, Hash, KeyEqual>;
+
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+using slru_cache = cache<Key, T, slru_policy, Hash, KeyEqual>;
+
+// Thread-safe cache split into Shards independent caches, each behind its
+// own mutex and picked by key hash, so threads working on different keys
+// rarely contend. Capacity and replacement are per shard. get() returns a
+// copy because a pointer would outlive the lock. Eviction callbacks run
+// under the shard's lock and must not call back into the cache.
+template <typename Cache, std::size_t Shards = 16>
+class concurrent_cache {
+ public:
+  using key_type = typename Cache::key_type;
+  using mapped_type = typename Cache::mapped_type;
+  using size_type = std::size_t;
+  using eviction_callback = typename Cache::eviction_callback;
+
+  static_assert(Shards > 0, "concurrent_cache needs a shard");
+
+  // Each shard holds capacity / Shards entries, rounded up.
+  explicit concurrent_cache(size_type capacity) {
+    if (capacity == 0) throw std::invalid_argument("cache capacity is 0");
+    shards.reserve(Shards);
+    for (size_type i = 0; i < Shards; ++i) {
+      shards.push_back(
+          std::make_unique<Shard>((capacity + Shards - 1) / Shards));
+    }
+  }
+
+  std::optional<mapped_type> get(const key_type &key) {
+    Shard &shard = shardOf(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    mapped_type *value = shard.cache.get(key);
+    if (value == nullptr) return std::nullopt;
+    return *value;
+  }
+
+  bool put(const key_type &key, mapped_type value) {
+    Shard &shard = shardOf(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.cache.put(key, std::move(value));
+  }
+
+  bool erase(const key_type &key) {
+    Shard &shard = shardOf(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.cache.erase(key);
+  }
+
+  bool contains(const key_type &key) {
+    Shard &shard = shardOf(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.cache.contains(key);
+  }
+
+  // Locks one shard at a time, so concurrent writers may make the total
+  // stale by the time it returns.
+  size_type size() {
+    size_type total = 0;
+    for (auto &shard : shards) {
+      std::lock_guard<std::mutex> guard(shard->lock);
+      total += shard->cache.size();
+    }
+    return total;
+  }
+
+  size_type capacity() const noexcept {
+    return Shards * shards.front()->cache.capacity();
+  }
+
+  void clear() {
+    for (auto &shard : shards) {
+      std::lock_guard<std::mutex> guard(shard->lock);
+      shard->cache.clear();
+    }
+  }
+
+  void set_eviction_callback(const eviction_callback &callback) {
+    for (auto &shard : shards) {
+      std::lock_guard<std::mutex> guard(shard->lock);
+      shard->cache.set_eviction_callback(callback);
+    }
+  }
+
+ private:
+  // Cache-line aligned so that neighbouring shard locks do not share a
+  // line.
+  struct alignas(64) Shard {
+    explicit Shard(size_type capacity) : cache(capacity) {}
+
+    std::mutex lock;
+    Cache cache;
+  };
+
+  // Uses the high bits of a multiplicative hash; the shard's own index
+  // uses the low bits of a different mix.
+  Shard &shardOf(const key_type &key) {
+    std::uint64_t h = std::uint64_t(typename Cache::hasher()(key));
+    h *= 0x9e3779b97f4a7c15ULL;
+    return *shards[(h >> 32) % Shards];
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards;
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_CACHE_H
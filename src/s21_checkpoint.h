@@ -0,0 +1,320 @@
+#ifndef S21_CONTAINERS_CHECKPOINT_H
+#define S21_CONTAINERS_CHECKPOINT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_binary_tree.h"
+
+namespace s21 {
+// Binary encoding of keys and values in checkpoint files. Trivially
+// copyable types are written as their bytes and strings as a length and
+// their characters; specialize for other types. read() returns false when
+// the stream ends before a whole value.
+template <typename T>
+struct checkpoint_codec {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "specialize s21::checkpoint_codec for this type");
+
+  static void write(std::ostream &out, const T &value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  static bool read(std::istream &in, T &value) {
+    return static_cast<bool>(
+        in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+  }
+};
+
+template <>
+struct checkpoint_codec<std::string> {
+  static void write(std::ostream &out, const std::string &value) {
+    checkpoint_codec<std::uint64_t>::write(out, value.size());
+    out.write(value.data(), value.size());
+  }
+
+  static bool read(std::istream &in, std::string &value) {
+    std::uint64_t size = 0;
+    if (!checkpoint_codec<std::uint64_t>::read(in, size)) return false;
+    value.resize(size);
+    return static_cast<bool>(in.read(&value[0], size));
+  }
+};
+
+// Checkpoint files of one map. The base image at path holds every element
+// in key order; path.delta holds, per checkpoint, the final state of each
+// key changed since the previous one. Compaction renames the delta log to
+// path.merging and merges it into a new base image, which can run on a
+// background thread while later checkpoints start a fresh delta log.
+// Recovery reads the base, then path.merging, then path.delta. Changed
+// keys are kept once each, ordered by the map's comparator, so the memory
+// and checkpoint cost follow the number of dirty keys rather than the
+// number of changes.
+template <typename Key, typename T, typename Compare>
+class Checkpointer {
+ public:
+  using size_type = std::size_t;
+  using value_type = std::pair<Key, T>;
+  using update_type = batch_update<value_type>;
+
+  Checkpointer(std::string path_, const Compare &comp_)
+      : path(std::move(path_)), comp(comp_), dirty(comp_) {}
+
+  Checkpointer(const Checkpointer &) = delete;
+  Checkpointer &operator=(const Checkpointer &) = delete;
+
+  ~Checkpointer() {
+    if (compaction.valid()) compaction.wait();
+  }
+
+  void noteDirty(const Key &key) { dirty.insertUnique(key); }
+
+  // Replaces all files with a base image of [first, last), which must be
+  // in key order. The old logs go first: replayed over the new image they
+  // would bring back stale values.
+  template <typename Iter>
+  void writeBase(Iter first, Iter last) {
+    waitForCompaction();
+    std::remove(mergingPath().c_str());
+    std::remove(deltaPath().c_str());
+    std::string tmp = path + ".tmp";
+    {
+      std::ofstream out = openOut(tmp, std::ios::trunc);
+      std::uint64_t count = 0;
+      writeHeader(out, count);
+      for (; first != last; ++first, ++count) {
+        checkpoint_codec<Key>::write(out, (*first).first);
+        checkpoint_codec<T>::write(out, (*first).second);
+      }
+      out.seekp(0);
+      writeHeader(out, count);
+      finish(out);
+    }
+    replace(tmp, path);
+    dirty.deleteTree();
+  }
+
+  // Appends the current state of every key changed since the last
+  // checkpoint; find(key) returns the element's value or nullptr once it
+  // is erased. Returns the number of records written. A write that fails
+  // cuts the log back to its old end, since replay stops at a torn record
+  // and would drop every later checkpoint; the keys stay dirty.
+  template <typename Find>
+  size_type writeDelta(Find find) {
+    std::error_code missing;
+    std::uintmax_t end = std::filesystem::file_size(deltaPath(), missing);
+    if (missing) end = 0;
+    std::ofstream out = openOut(deltaPath(), std::ios::app);
+    try {
+      for (Node *node = dirty.minNode(); node != nullptr;
+           node = node->nextInTree()) {
+        const Key &key = node->data;
+        const T *value = find(key);
+        out.put(static_cast<char>(value != nullptr ? batch_op::insert
+                                                   : batch_op::erase));
+        checkpoint_codec<Key>::write(out, key);
+        if (value != nullptr) checkpoint_codec<T>::write(out, *value);
+      }
+      finish(out);
+    } catch (...) {
+      out.close();
+      std::error_code ignored;
+      std::filesystem::resize_file(deltaPath(), end, ignored);
+      throw;
+    }
+    size_type written = dirty.size();
+    dirty.deleteTree();
+    return written;
+  }
+
+  // Folds the delta log into the base image. A compaction still running
+  // is waited for first; errors of a background compaction are rethrown
+  // by the next call that waits for it.
+  void compact(bool background) {
+    waitForCompaction();
+    if (!std::ifstream(deltaPath())) return;
+    if (std::ifstream(mergingPath())) {
+      appendFile(deltaPath(), mergingPath());
+      std::remove(deltaPath().c_str());
+    } else {
+      replace(deltaPath(), mergingPath());
+    }
+    if (background) {
+      compaction = std::async(std::launch::async, [this] { mergeFiles(); });
+    } else {
+      mergeFiles();
+    }
+  }
+
+  void waitForCompaction() {
+    if (compaction.valid()) compaction.get();
+  }
+
+  // The base image as sorted inserts and the logged changes in the order
+  // they were made.
+  static void load(const std::string &path, std::vector<update_type> &base,
+                   std::vector<update_type> &changes) {
+    std::ifstream in(path, std::ios::binary);
+    std::uint64_t count = 0;
+    if (!in || !readHeader(in, count)) {
+      throw std::runtime_error("no checkpoint at " + path);
+    }
+    base.reserve(count);
+    update_type update{batch_op::insert, value_type()};
+    for (std::uint64_t i = 0; i < count; ++i) {
+      if (!readRecord(in, update, false)) {
+        throw std::runtime_error("truncated checkpoint " + path);
+      }
+      base.push_back(update);
+    }
+    readChanges(path + ".merging", changes);
+    readChanges(path + ".delta", changes);
+  }
+
+ private:
+  static constexpr char kMagic[4] = {'S', '2', '1', 'C'};
+
+  std::string deltaPath() const { return path + ".delta"; }
+  std::string mergingPath() const { return path + ".merging"; }
+
+  static std::ofstream openOut(const std::string &file,
+                               std::ios::openmode mode) {
+    std::ofstream out(file, std::ios::binary | mode);
+    if (!out) throw std::runtime_error("cannot write " + file);
+    return out;
+  }
+
+  static void finish(std::ofstream &out) {
+    out.flush();
+    if (!out) throw std::runtime_error("checkpoint write failed");
+  }
+
+  static void replace(const std::string &from, const std::string &to) {
+    if (std::rename(from.c_str(), to.c_str()) != 0) {
+      throw std::runtime_error("cannot rename " + from);
+    }
+  }
+
+  static void writeHeader(std::ostream &out, std::uint64_t count) {
+    out.write(kMagic, sizeof(kMagic));
+    checkpoint_codec<std::uint64_t>::write(out, count);
+  }
+
+  static bool readHeader(std::istream &in, std::uint64_t &count) {
+    char magic[sizeof(kMagic)];
+    if (!in.read(magic, sizeof(magic))) return false;
+    if (!std::equal(magic, magic + sizeof(magic), kMagic)) return false;
+    return checkpoint_codec<std::uint64_t>::read(in, count);
+  }
+
+  // Base records are key and value; delta records start with the batch_op
+  // and carry a value only for inserts.
+  static bool readRecord(std::istream &in, update_type &update,
+                         bool withOp) {
+    if (withOp) {
+      int op = in.get();
+      if (op != static_cast<int>(batch_op::insert) &&
+          op != static_cast<int>(batch_op::erase)) {
+        return false;
+      }
+      update.op = static_cast<batch_op>(op);
+    }
+    if (!checkpoint_codec<Key>::read(in, update.value.first)) return false;
+    return update.op == batch_op::erase ||
+           checkpoint_codec<T>::read(in, update.value.second);
+  }
+
+  // A record cut short by a crash ends the log.
+  static void readChanges(const std::string &file,
+                          std::vector<update_type> &changes) {
+    std::ifstream in(file, std::ios::binary);
+    update_type update{batch_op::insert, value_type()};
+    while (in && readRecord(in, update, true)) changes.push_back(update);
+  }
+
+  static void appendFile(const std::string &from, const std::string &to) {
+    std::ifstream in(from, std::ios::binary);
+    std::ofstream out = openOut(to, std::ios::app);
+    if (in.peek() != std::ifstream::traits_type::eof()) out << in.rdbuf();
+    finish(out);
+  }
+
+  // Streams the base image through a merge with the sorted changes, so
+  // memory stays proportional to the delta, not to the map. The merged log
+  // is removed only after the new image is in place; if that step is cut
+  // short, replaying the log again on recovery is harmless because every
+  // record is the final state of its key.
+  void mergeFiles() {
+    std::vector<update_type> changes;
+    readChanges(mergingPath(), changes);
+    std::stable_sort(changes.begin(), changes.end(),
+                     [&](const update_type &a, const update_type &b) {
+                       return comp(a.value.first, b.value.first);
+                     });
+    std::ifstream in(path, std::ios::binary);
+    std::uint64_t remaining = 0;
+    if (!in || !readHeader(in, remaining)) {
+      throw std::runtime_error("no checkpoint at " + path);
+    }
+    std::string tmp = path + ".tmp";
+    std::ofstream out = openOut(tmp, std::ios::trunc);
+    std::uint64_t count = 0;
+    writeHeader(out, count);
+    auto emit = [&](const value_type &value) {
+      checkpoint_codec<Key>::write(out, value.first);
+      checkpoint_codec<T>::write(out, value.second);
+      ++count;
+    };
+    update_type current{batch_op::insert, value_type()};
+    bool haveCurrent = remaining > 0 && readRecord(in, current, false);
+    size_type i = 0;
+    while (haveCurrent || i < changes.size()) {
+      // The last change of a key wins.
+      while (i + 1 < changes.size() &&
+             !comp(changes[i].value.first, changes[i + 1].value.first)) {
+        ++i;
+      }
+      bool takeChange =
+          i < changes.size() &&
+          (!haveCurrent ||
+           !comp(current.value.first, changes[i].value.first));
+      if (takeChange) {
+        bool replaces = haveCurrent &&
+                        !comp(changes[i].value.first, current.value.first);
+        if (changes[i].op == batch_op::insert) emit(changes[i].value);
+        ++i;
+        if (!replaces) continue;
+      } else {
+        emit(current.value);
+      }
+      haveCurrent = --remaining > 0 && readRecord(in, current, false);
+    }
+    out.seekp(0);
+    writeHeader(out, count);
+    finish(out);
+    out.close();
+    replace(tmp, path);
+    std::remove(mergingPath().c_str());
+  }
+
+  using KeySet = BinaryTree<Key, Key, Compare>;
+  using Node = typename KeySet::Node;
+
+  std::string path;
+  Compare comp;
+  KeySet dirty;
+  std::future<void> compaction;
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_CHECKPOINT_H
@@ -1,7 +1,15 @@
 #ifndef S21_CONTAINERS_S21_CONTAINERSPLUS_H_
 #define S21_CONTAINERS_S21_CONTAINERSPLUS_H_
 
+#include "s21_adaptive.h"
 #include "s21_array.h"
+#include "s21_bitmap_set.h"
+#include "s21_cache.h"
+#include "s21_interval_map.h"
+#include "s21_multi_index.h"
+#include "s21_multimap.h"
 #include "s21_multiset.h"
+#include "s21_split_map.h"
+#include "s21_static_map.h"
 
 #endif  // S21_CONTAINERS_S21_CONTAINERSPLUS_H_
@@ -0,0 +1,208 @@
+#ifndef S21_CONTAINERS_INTERVAL_MAP_H
+#define S21_CONTAINERS_INTERVAL_MAP_H
+
+#include "s21_binary_tree.h"
+
+namespace s21 {
+// Closed interval [low, high] of an interval_map.
+template <typename Endpoint>
+struct interval {
+  Endpoint low;
+  Endpoint high;
+
+  bool operator==(const interval &other) const {
+    return low == other.low && high == other.high;
+  }
+};
+
+// Orders intervals by low endpoint, then by high endpoint.
+template <typename Endpoint, typename Compare>
+struct IntervalOrder {
+  bool operator()(const interval<Endpoint> &a,
+                  const interval<Endpoint> &b) const {
+    if (comp(a.low, b.low)) return true;
+    if (comp(b.low, a.low)) return false;
+    return comp(a.high, b.high);
+  }
+
+  Compare comp;
+};
+
+// Subtree summary of an interval tree: the largest high endpoint below a
+// node, compared with the endpoint order held by the tree's comparator.
+template <typename Endpoint>
+struct MaxEndpoint {
+  using summary_type = Endpoint;
+  static constexpr bool uses_key_compare = true;
+
+  template <typename Value>
+  static const Endpoint &of(const Value &value) noexcept {
+    return value.first.high;
+  }
+
+  template <typename Order>
+  static const Endpoint &combine(const Order &order, const Endpoint &a,
+                                 const Endpoint &b) {
+    return order.comp(a, b) ? b : a;
+  }
+};
+
+// Map from closed intervals to values that finds every interval containing
+// a point (stab) or meeting a range (overlap). Each node caches the largest
+// high endpoint of its subtree, so a query skips every subtree that ends
+// before the probe and every right subtree that starts after it. A query
+// with k results costs O((k + 1) log n), and never more than O(n); the
+// results are streamed to a callback in key order without building a
+// result set. Compare orders endpoints.
+template <typename Endpoint, typename T, typename Compare = std::less<Endpoint>,
+          typename Balance = avl_balance>
+class interval_map {
+ public:
+  using endpoint_type = Endpoint;
+  using interval_type = interval<Endpoint>;
+  using key_type = interval_type;
+  using mapped_type = T;
+  using value_type = std::pair<key_type, mapped_type>;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using size_type = std::size_t;
+
+  using key_compare = IntervalOrder<Endpoint, Compare>;
+  using balance_type = augmented<Balance, MaxEndpoint<Endpoint>>;
+  using tree_type =
+      BinaryTree<key_type, value_type, key_compare, balance_type>;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using Node = typename tree_type::Node;
+
+  interval_map() = default;
+
+  explicit interval_map(const Compare &comp) : tree(key_compare{comp}) {}
+
+  interval_map(std::initializer_list<value_type> const &items,
+               const Compare &comp = Compare())
+      : tree(key_compare{comp}) {
+    for (auto item : items) {
+      insert(item);
+    }
+  }
+
+  interval_map(const interval_map &m) : tree(m.tree) {}
+
+  interval_map(interval_map &&m) : tree(std::move(m.tree)) {}
+
+  interval_map &operator=(interval_map &m) {
+    if (this != &m) {
+      tree = m.tree;
+    }
+    return *this;
+  }
+
+  interval_map &operator=(interval_map &&m) {
+    if (this != &m) {
+      clear();
+      tree = std::move(m.tree);
+    }
+    return *this;
+  }
+
+  T &at(const key_type &key) {
+    Node *node = tree.search(key);
+    if (node == nullptr) throw std::out_of_range("no interval found");
+    return node->data.second;
+  }
+
+  iterator begin() { return iterator(tree.minNode(), tree.getRoot()); }
+
+  iterator end() { return iterator(nullptr, tree.getRoot()); }
+
+  const_iterator cbegin() const noexcept {
+    return const_iterator(tree.minNode(), tree.getRoot());
+  }
+
+  const_iterator cend() const noexcept {
+    return const_iterator(nullptr, tree.getRoot());
+  }
+
+  bool empty() { return tree.empty(); }
+
+  size_type size() { return tree.size(); }
+
+  size_type max_size() {
+    return (std::numeric_limits<size_type>::max() / 2) / sizeof(Node);
+  }
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    if (tree.keyCompare().comp(value.first.high, value.first.low)) {
+      throw std::invalid_argument("interval ends before it starts");
+    }
+    return tree.insertUnique(value);
+  }
+
+  std::pair<iterator, bool> insert(const Endpoint &low, const Endpoint &high,
+                                   const T &obj) {
+    return insert(value_type{interval_type{low, high}, obj});
+  }
+
+  void erase(iterator pos) { tree.erase(pos); }
+
+  size_type erase(const key_type &key) {
+    Node *node = tree.search(key);
+    if (node == nullptr) return 0;
+    tree.erase(iterator(node, tree.getRoot()));
+    return 1;
+  }
+
+  void swap(interval_map &other) { tree.swap(other.tree); }
+
+  void clear() { tree.clearTree(); }
+
+  iterator find(const key_type &key) { return tree.find(key); }
+
+  bool contains(const key_type &key) { return tree.contains(key); }
+
+  // Calls fn(interval, value) for every interval that contains point.
+  template <typename Fn>
+  void stab(const Endpoint &point, Fn &&fn) {
+    overlap(interval_type{point, point}, fn);
+  }
+
+  // Calls fn(interval, value) for every interval that shares at least one
+  // point with range, in key order.
+  template <typename Fn>
+  void overlap(const interval_type &range, Fn &&fn) {
+    if (!tree.empty()) visitOverlaps(tree.getRoot(), range, fn);
+  }
+
+  size_type count_overlapping(const interval_type &range) {
+    size_type result = 0;
+    overlap(range, [&](const interval_type &, T &) { ++result; });
+    return result;
+  }
+
+  // The largest high endpoint of all intervals; the map must not be empty.
+  const Endpoint &max_endpoint() const {
+    return tree.getRoot()->fields.summary;
+  }
+
+ private:
+  // Recurses into left subtrees only and loops down the right spine, so the
+  // stack depth is bounded by the tree height.
+  template <typename Fn>
+  void visitOverlaps(Node *node, const interval_type &range, Fn &fn) const {
+    const Compare &comp = tree.keyCompare().comp;
+    while (node != nullptr && !comp(node->fields.summary, range.low)) {
+      visitOverlaps(node->left, range, fn);
+      const interval_type &key = node->data.first;
+      if (comp(range.high, key.low)) return;
+      if (!comp(key.high, range.low)) fn(key, node->data.second);
+      node = node->right;
+    }
+  }
+
+  tree_type tree;
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_INTERVAL_MAP_H
@@ -29,7 +29,8 @@ class list {
   };
   Node_ *head_ = nullptr;
   Node_ *tail_ = nullptr;
-  Node_ *end_ = nullptr;
+  // Embedded sentinel, so an empty list owns no heap memory.
+  Node_ end_;
   size_type size_ = 0;
 
   class ListConstIterator {
@@ -88,43 +89,28 @@ class list {
   };
 
  public:
-  list() {
-    head_ = tail_ = nullptr;
-    end_ = new Node_();
-  };
+  list() = default;
   explicit list(size_type n) {
-    end_ = new Node_();
     for (size_type i = 0; i < n; i++) {
       push_back(T());
     }
   }
   list(std::initializer_list<value_type> const &items)
-      : head_(nullptr), tail_(nullptr), end_(nullptr), size_(0) {
-    if (items.size() != 0) {
-      end_ = new Node_();
-      for (value_type n : items) {
-        push_back(n);
-      }
+      : head_(nullptr), tail_(nullptr), size_(0) {
+    for (value_type n : items) {
+      push_back(n);
     }
   }
-  list(const list &l)
-      : head_(nullptr), tail_(nullptr), end_(nullptr), size_(0) {
-    end_ = new Node_();
+  list(const list &l) : head_(nullptr), tail_(nullptr), size_(0) {
     Node_ *current = l.head_;
     for (size_type i = 0; i != l.size_; i++) {
       push_back(current->value_);
       current = current->next_;
     }
   }
-  list(list &&l) noexcept {
-    head_ = std::exchange(l.head_, nullptr);
-    tail_ = std::exchange(l.tail_, nullptr);
-    end_ = std::exchange(l.end_, nullptr);
-    size_ = std::exchange(l.size_, 0);
-  }
+  list(list &&l) noexcept { swap(l); }
   ~list() {
     if (!empty()) clear();
-    delete end_;
   };
   list &operator=(list &&l) noexcept {
     if (this != &l) {
@@ -139,18 +125,18 @@ class list {
   using iterator = ListIterator;
   using const_iterator = ListConstIterator;
 
-  iterator begin() const { return !head_ ? iterator(end_) : iterator(head_); }
-  iterator end() const { return iterator(end_); }
+  iterator begin() const { return !head_ ? end() : iterator(head_); }
+  iterator end() const { return iterator(const_cast<Node_ *>(&end_)); }
   const_reference front() {
     if (empty()) {
-      return end_->value_;
+      return end_.value_;
     } else {
       return head_->value_;
     }
   }
   const_reference back() {
     if (empty()) {
-      return end_->value_;
+      return end_.value_;
     } else {
       return tail_->value_;
     }
@@ -180,7 +166,7 @@ class list {
         head_ = nullptr;
       }
       size_--;
-      end_->value_ = size_;
+      end_.value_ = size_;
     }
   }
 
@@ -197,7 +183,7 @@ class list {
         head_ = nullptr;
       }
       size_--;
-      end_->value_ = size_;
+      end_.value_ = size_;
     }
   }
 
@@ -206,18 +192,18 @@ class list {
     if (empty()) {
       head_ = new_node_;
       tail_ = new_node_;
-      head_->next_ = end_;
-      head_->prev_ = end_;
+      head_->next_ = &end_;
+      head_->prev_ = &end_;
     } else {
       new_node_->next_ = head_;
       head_->prev_ = new_node_;
       head_ = new_node_;
-      head_->prev_ = end_;
-      end_->prev_ = tail_;
-      end_->next_ = head_;
+      head_->prev_ = &end_;
+      end_.prev_ = tail_;
+      end_.next_ = head_;
     }
     size_++;
-    end_->value_ = size_;
+    end_.value_ = size_;
   }
 
   void push_back(const_reference value) {
@@ -225,18 +211,18 @@ class list {
     if (empty()) {
       head_ = new_node_;
       tail_ = new_node_;
-      head_->next_ = end_;
-      head_->prev_ = end_;
+      head_->next_ = &end_;
+      head_->prev_ = &end_;
     } else {
       tail_->next_ = new_node_;
       new_node_->prev_ = tail_;
       tail_ = new_node_;
-      tail_->next_ = end_;
-      end_->prev_ = tail_;
-      end_->next_ = head_;
+      tail_->next_ = &end_;
+      end_.prev_ = tail_;
+      end_.next_ = head_;
     }
     size_++;
-    end_->value_ = size_;
+    end_.value_ = size_;
   }
 
   void swap(list &other) {
@@ -244,22 +230,26 @@ class list {
     swap(this->head_, other.head_);
     swap(this->tail_, other.tail_);
     swap(this->size_, other.size_);
-    swap(this->end_, other.end_);
+    swap(this->end_.value_, other.end_.value_);
+    swap(this->end_.prev_, other.end_.prev_);
+    swap(this->end_.next_, other.end_.next_);
+    relinkEnd();
+    other.relinkEnd();
   }
 
   iterator insert(iterator pos, const_reference value) {
     Node_ *current = pos.cursor;
     if (empty()) {
       push_back(value);
-      end_->value_ = size_;
+      end_.value_ = size_;
       return iterator(head_);
     } else if (current == head_) {
       push_front(value);
-      end_->value_ = size_;
+      end_.value_ = size_;
       return iterator(head_);
-    } else if (current == end_) {
+    } else if (current == &end_) {
       push_back(value);
-      end_->value_ = size_;
+      end_.value_ = size_;
       return iterator(tail_);
     } else {
       Node_ *add = new Node_(value);
@@ -268,30 +258,30 @@ class list {
       current->prev_->next_ = add;
       current->prev_ = add;
       size_++;
-      end_->value_ = size_;
+      end_.value_ = size_;
       return iterator(add);
     }
   }
 
   void erase(iterator pos) {
-    if (pos.cursor == nullptr || pos.cursor == end_) {
+    if (pos.cursor == nullptr || pos.cursor == &end_) {
       throw std::logic_error("Invalid position");
     }
     if (pos.cursor == head_) {
       pop_front();
-      end_->value_ = size_;
+      end_.value_ = size_;
       if (size_ == 0) {
         head_ = nullptr;
       }
     } else if (pos.cursor == tail_) {
       pop_back();
-      end_->value_ = size_;
+      end_.value_ = size_;
     } else {
       pos.cursor->prev_->next_ = pos.cursor->next_;
       pos.cursor->next_->prev_ = pos.cursor->prev_;
       delete pos.cursor;
       size_--;
-      end_->value_ = size_;
+      end_.value_ = size_;
     }
   }
 
@@ -308,9 +298,9 @@ class list {
   void reverse() {
     if (!empty() && size_ != 1) {
       std::swap(tail_, head_);
-      std::swap(end_->prev_, end_->next_);
+      std::swap(end_.prev_, end_.next_);
       auto iter = begin();
-      while (iter.cursor != end_) {
+      while (iter.cursor != &end_) {
         std::swap(iter.cursor->next_, iter.cursor->prev_);
         ++iter;
       }
@@ -392,6 +382,13 @@ class list {
   }
 
  private:
+  // Points the ends of the chain at this list's own sentinel.
+  void relinkEnd() noexcept {
+    if (empty()) return;
+    head_->prev_ = &end_;
+    tail_->next_ = &end_;
+  }
+
   iterator partition(iterator first, iterator last) {
     value_type pivot_value = last.cursor->value_;
     iterator it = first;
@@ -407,7 +404,7 @@ class list {
   }
 
   void quick_sort(iterator first, iterator last) {
-    if (first == last || first.cursor == end_ || last.cursor == end_ ||
+    if (first == last || first.cursor == &end_ || last.cursor == &end_ ||
         first.cursor == tail_)
       return;
     iterator pivot = partition(first, last);
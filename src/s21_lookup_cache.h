@@ -0,0 +1,78 @@
+#ifndef S21_CONTAINERS_LOOKUP_CACHE_H
+#define S21_CONTAINERS_LOOKUP_CACHE_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+// Two-way set-associative cache of pointers to recently found elements,
+// indexed by key hash. The owner supplies the hash and an equality check on
+// lookup, and must invalidate entries before the elements they point to are
+// destroyed.
+template <typename Value>
+class LookupCache {
+ public:
+  using size_type = std::size_t;
+
+  struct Stats {
+    size_type hits = 0;
+    size_type misses = 0;
+  };
+
+  explicit LookupCache(size_type slots) {
+    size_type sets = 1;
+    while (sets * 2 < slots) sets *= 2;
+    slots_.resize(sets * 2);
+    mask_ = sets - 1;
+  }
+
+  template <typename Equal>
+  Value *find(std::uint64_t hash, Equal equal) const {
+    Slot *set = &slots_[(hash & mask_) * 2];
+    for (int way = 0; way < 2; ++way) {
+      if (set[way].value != nullptr && set[way].hash == hash &&
+          equal(*set[way].value)) {
+        if (way == 1) std::swap(set[0], set[1]);
+        ++stats_.hits;
+        return set[0].value;
+      }
+    }
+    ++stats_.misses;
+    return nullptr;
+  }
+
+  void store(std::uint64_t hash, Value *value) const noexcept {
+    Slot *set = &slots_[(hash & mask_) * 2];
+    set[1] = set[0];
+    set[0] = Slot{hash, value};
+  }
+
+  void invalidate(std::uint64_t hash) noexcept {
+    Slot *set = &slots_[(hash & mask_) * 2];
+    for (int way = 0; way < 2; ++way) {
+      if (set[way].hash == hash) set[way] = Slot();
+    }
+  }
+
+  void clear() noexcept {
+    for (auto &slot : slots_) slot = Slot();
+  }
+
+  size_type slots() const noexcept { return slots_.size(); }
+  const Stats &stats() const noexcept { return stats_; }
+
+ private:
+  struct Slot {
+    std::uint64_t hash = 0;
+    Value *value = nullptr;
+  };
+
+  mutable std::vector<Slot> slots_;
+  size_type mask_;
+  mutable Stats stats_;
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_LOOKUP_CACHE_H
@@ -2,10 +2,15 @@
 #define S21_CONTAINERS_MAP_H
 
 #include "s21_binary_tree.h"
+#include "s21_bloom_filter.h"
+#include "s21_checkpoint.h"
+#include "s21_lookup_cache.h"
+#include "s21_undo_log.h"
 #include "s21_vector.h"
 
 namespace s21 {
-template <typename Key, typename T>
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Balance = avl_balance>
 class map {
  public:
   using key_type = Key;
@@ -15,93 +20,245 @@ class map {
   using const_reference = const value_type&;
   using size_type = std::size_t;
 
-  struct mapCompare {
-    bool operator()(const value_type& a, const value_type& b) const noexcept {
-      return a.first < b.first;
+  using key_compare = Compare;
+  using tree_type = BinaryTree<key_type, value_type, Compare, Balance>;
+
+  // Orders stored pairs by their keys.
+  class value_compare {
+   public:
+    bool operator()(const value_type& a, const value_type& b) const {
+      return comp(a.first, b.first);
     }
+
+   protected:
+    friend class map;
+    explicit value_compare(const Compare& c) : comp(c) {}
+    Compare comp;
   };
 
-  using iterator =
-      typename BinaryTree<key_type, value_type, mapCompare>::iterator;
-  using const_iterator =
-      typename BinaryTree<key_type, value_type, mapCompare>::const_iterator;
-  using Node = typename BinaryTree<key_type, value_type, mapCompare>::Node;
+  using update_type = batch_update<value_type>;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using Node = typename tree_type::Node;
+  using bloom_stats = typename BloomFilter<Key>::Stats;
+  using cache_stats = typename LookupCache<Node>::Stats;
+  using undo_log = UndoLog<value_type>;
+  using change = typename undo_log::change;
+  using checkpointer = Checkpointer<Key, T, Compare>;
+
+  map() = default;
 
-  map() : tree(new BinaryTree<key_type, value_type, mapCompare>) {}
+  explicit map(const Compare& comp) : tree(comp) {}
 
-  map(std::initializer_list<value_type> const& items)
-      : tree(new BinaryTree<key_type, value_type, mapCompare>()) {
+  map(std::initializer_list<value_type> const& items,
+      const Compare& comp = Compare())
+      : tree(comp) {
     for (auto item : items) {
       insert(item);
     }
   }
 
-  map(const map& m) : tree(new BinaryTree<key_type, value_type, mapCompare>(*m.tree)) {}
-
-  map(map&& m) : tree(new BinaryTree<key_type, value_type, mapCompare>(std::move(*m.tree))) {}
-
+  // A copy starts with an empty lookup cache of the same size: cached
+  // pointers refer to the nodes of the source map.
+  map(const map& m)
+      : tree(m.tree),
+        bloom(m.bloom ? new BloomFilter<Key>(*m.bloom) : nullptr),
+        cache(m.cache ? new LookupCache<Node>(m.cache->slots())
+                      : nullptr) {}
+
+  map(map&& m)
+      : tree(std::move(m.tree)),
+        bloom(std::exchange(m.bloom, nullptr)),
+        cache(std::exchange(m.cache, nullptr)),
+        undo(std::exchange(m.undo, nullptr)),
+        checkpoints(std::exchange(m.checkpoints, nullptr)) {}
+
+  // Inside a transaction an assignment is logged as erasing every element
+  // and inserting the new ones.
   map& operator=(map& m) {
-    *tree = *m.tree;
+    if (this != &m) {
+      logAll(change::erased);
+      tree = m.tree;
+      logAll(change::inserted);
+      delete bloom;
+      bloom = m.bloom ? new BloomFilter<Key>(*m.bloom) : nullptr;
+      if (cache != nullptr) cache->clear();
+    }
     return *this;
   }
 
+  // The elements move; the transaction, checkpoints and reclaim setting
+  // stay with their map. The target logs the move as replacing its
+  // elements and the emptied source logs its elements as erased.
   map& operator=(map&& m) {
-    clear();
-    *tree = std::move(*m.tree);
+    if (this != &m) {
+      clear();
+      m.logAll(change::erased);
+      tree = std::move(m.tree);
+      logAll(change::inserted);
+      std::swap(bloom, m.bloom);
+      std::swap(cache, m.cache);
+    }
     return *this;
   }
 
   ~map() {
-    delete tree;
-    tree = nullptr;
+    tree.deleteTree(backgroundReclaim);
+    delete bloom;
+    bloom = nullptr;
+    delete cache;
+    cache = nullptr;
+    delete undo;
+    undo = nullptr;
+    delete checkpoints;
+    checkpoints = nullptr;
+  }
+
+  // at(), operator[] and try_get() are reads and log nothing, so reading
+  // inside a transaction or between checkpoints costs nothing extra. A
+  // value changed through the reference they return is therefore neither
+  // undone by rollback() nor written by checkpoint(); the same holds for
+  // writes through iterators and for_each_in_range. Change values with
+  // insert_or_assign, upsert, compute or modify. operator[] still logs the
+  // element it inserts for an absent key.
+  T& at(const Key& key) {
+    Node* node = findNode(key);
+    if (node == nullptr) throw std::out_of_range("no key found");
+    return node->data.second;
   }
 
-  T& at(const Key& key) { return (*tree->at(key)).second; }
+  const T& at(const Key& key) const {
+    Node* node = findNode(key);
+    if (node == nullptr) throw std::out_of_range("no key found");
+    return node->data.second;
+  }
 
-  T& operator[](const Key& key) { return at(key); }
+  // Inserts a value-initialized element when the key is absent.
+  T& operator[](const Key& key) { return (*try_emplace(key).first).second; }
 
-  iterator begin() { return iterator(tree->minNode(), tree->getRoot()); }
+  iterator begin() { return iterator(tree.minNode(), tree.getRoot()); }
 
-  iterator end() { return iterator(nullptr, tree->getRoot()); }
+  iterator end() { return iterator(nullptr, tree.getRoot()); }
 
   const_iterator cbegin() const noexcept {
-    return const_iterator(tree->minNode(), tree->getRoot());
+    return const_iterator(tree.minNode(), tree.getRoot());
   }
 
   const_iterator cend() const noexcept {
-    return const_iterator(nullptr, tree->getRoot());
+    return const_iterator(nullptr, tree.getRoot());
   }
 
-  bool empty() { return tree->empty(); }
+  bool empty() { return tree.empty(); }
 
-  size_type size() { return tree->size(); }
+  size_type size() { return tree.size(); }
 
   size_type max_size() {
     return (std::numeric_limits<size_type>::max() / 2) / sizeof(Node);
   }
 
   std::pair<iterator, bool> insert(const reference value) {
-    return tree->insertUnique(value);
+    return insertValue(value);
   }
 
   std::pair<iterator, bool> insert(const Key& key, const T& obj) {
-    return tree->insertUnique(value_type{key, obj});
+    return insertValue(value_type{key, obj});
   }
 
   std::pair<iterator, bool> insert_or_assign(const Key& key, const T& obj) {
-    value_type value = std::make_pair(key, obj);
-    std::pair<iterator, bool> result = insert(value);
-    if (result.second == false) {
-      (*(result.first)).second = obj;
+    std::pair<iterator, bool> result =
+        emplaceKey(key, [&] { return value_type(key, obj); });
+    if (!result.second) {
+      logChange(change::assigned, *result.first);
+      (*result.first).second = obj;
+      tree.refreshPath(result.first.iter);
     }
     return result;
   }
 
-  void erase(iterator pos) { tree->erase(pos); }
+  // Constructs the mapped value from args only if the key is absent; an
+  // existing element is left untouched.
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    return emplaceKey(key, [&] {
+      return value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+    });
+  }
 
-  void swap(map& other) { std::swap(tree, other.tree); }
+  // Calls fn(T&) on the element for key, value-initializing it first when
+  // the key is absent. Returns whether the element was created.
+  template <typename Fn>
+  std::pair<iterator, bool> upsert(const Key& key, Fn&& fn) {
+    std::pair<iterator, bool> result = try_emplace(key);
+    if (!result.second) logChange(change::assigned, *result.first);
+    fn((*result.first).second);
+    tree.refreshPath(result.first.iter);
+    return result;
+  }
 
-  void clear() { tree->clearTree(); }
+  // Calls fn(T&) on the element for key and returns true, or returns false
+  // for an absent key. Unlike a write through at(), the change is logged.
+  template <typename Fn>
+  bool modify(const Key& key, Fn&& fn) {
+    Node* node = findNode(key);
+    if (node == nullptr) return false;
+    logChange(change::assigned, node->data);
+    fn(node->data.second);
+    tree.refreshPath(node);
+    return true;
+  }
+
+  // Sets the element for key to fn(key, current), where current points to
+  // the existing value or is nullptr; a new element is initialized directly
+  // from the result.
+  template <typename Fn>
+  std::pair<iterator, bool> compute(const Key& key, Fn&& fn) {
+    std::pair<iterator, bool> result = emplaceKey(
+        key, [&] { return value_type(key, fn(key, (const T*)nullptr)); });
+    if (!result.second) {
+      logChange(change::assigned, *result.first);
+      T& current = (*result.first).second;
+      current = fn(key, (const T*)&current);
+      tree.refreshPath(result.first.iter);
+    }
+    return result;
+  }
+
+  void erase(iterator pos) {
+    logChange(change::erased, *pos);
+    if (cache != nullptr) cache->invalidate(keyHash((*pos).first));
+    tree.erase(pos);
+    if (bloom != nullptr) bloom->noteErase();
+  }
+
+  void swap(map& other) {
+    tree.swap(other.tree);
+    std::swap(bloom, other.bloom);
+    std::swap(cache, other.cache);
+    std::swap(undo, other.undo);
+    std::swap(checkpoints, other.checkpoints);
+  }
+
+  void clear() {
+    logAll(change::erased);
+    tree.clearTree(backgroundReclaim);
+    if (bloom != nullptr) bloom->clear();
+    if (cache != nullptr) cache->clear();
+  }
+
+  // Opt-in: clear() and the destructor hand the elements to a background
+  // thread and return at once. Element destructors then run on that thread.
+  void set_background_reclaim(bool enabled) noexcept {
+    backgroundReclaim = enabled;
+  }
+
+  bool background_reclaim() const noexcept { return backgroundReclaim; }
+
+  // Shape of the underlying tree plus, when built with
+  // S21_CONTAINERS_STATS, its operation counters. Takes O(n).
+  tree_stats stats() const { return tree.stats(); }
+
+  void reset_counters() noexcept { tree.resetCounters(); }
 
   void merge(map& other) {
     auto otherEnd = other.end();
@@ -111,7 +268,287 @@ class map {
     other.clear();
   }
 
-  bool contains(const Key& key) { return tree->containsPair(key); }
+  // Calls fn on each element with a key in [lo, hi), in key order.
+  template <typename Fn>
+  void for_each_in_range(const Key& lo, const Key& hi, Fn fn) {
+    tree.forEachInRange(lo, hi, [&](value_type& value) { fn(value); });
+  }
+
+  // Moves all elements into one contiguous block in the given layout to
+  // restore memory locality after churn. Invalidates iterators and element
+  // pointers.
+  void compact(node_layout layout = node_layout::in_order) {
+    if (cache != nullptr) cache->clear();
+    tree.compact(layout);
+  }
+
+  // Incremental compaction: begin_compact fixes the order and each
+  // compact_step moves at most max_nodes elements, returning true when done.
+  // Elements moved by a step invalidate their iterators and pointers.
+  void begin_compact(node_layout layout = node_layout::in_order) {
+    tree.beginCompaction(layout);
+  }
+
+  bool compact_step(size_type max_nodes) {
+    if (cache != nullptr) cache->clear();
+    return tree.compactStep(max_nodes);
+  }
+
+  // Applies a batch of inserts and erases in one sorted merge. A later
+  // update of the same key overrides an earlier one; an insert of a present
+  // key overwrites the element.
+  void apply_batch(std::vector<update_type> updates) {
+    if (undo != nullptr || checkpoints != nullptr) logBatch(updates);
+    if (bloom != nullptr) {
+      for (const update_type& update : updates) {
+        if (update.op == batch_op::insert) {
+          bloom->insert(update.value.first);
+        } else {
+          bloom->noteErase();
+        }
+      }
+    }
+    tree.applyBatch(std::move(updates));
+    if (cache != nullptr) cache->clear();
+    if (bloom != nullptr && bloom->overloaded()) rebuildBloom(2 * size());
+  }
+
+  // Removes all elements matching pred in one traversal and returns how
+  // many were removed.
+  template <typename Pred>
+  size_type erase_if(Pred pred) {
+    size_type removed = tree.eraseIf([&](const value_type& value) {
+      if (!pred(value)) return false;
+      logChange(change::erased, value);
+      return true;
+    });
+    if (removed != 0) {
+      if (cache != nullptr) cache->clear();
+      if (bloom != nullptr) bloom->noteErase(removed);
+    }
+    return removed;
+  }
+
+  bool contains(const Key& key) { return findNode(key) != nullptr; }
+
+  // Transactions: from begin_txn() on, every change is logged with what is
+  // needed to reverse it, so a rollback costs O(k log n) for k changes
+  // rather than a copy of the map. savepoint() marks a position that
+  // rollback(savepoint) returns to while the transaction stays open;
+  // rollback() undoes everything and commit() keeps it, both ending the
+  // transaction. Values written through iterators or for_each_in_range
+  // are not logged.
+  void begin_txn() {
+    if (undo != nullptr) throw std::logic_error("transaction already open");
+    undo = new undo_log;
+  }
+
+  bool in_txn() const noexcept { return undo != nullptr; }
+
+  size_type savepoint() const { return activeLog()->savepoint(); }
+
+  void rollback(size_type savepoint) {
+    activeLog()->rollbackTo(savepoint, [this](const auto& entry) {
+      undoChange(entry.kind, entry.value);
+    });
+  }
+
+  void rollback() {
+    rollback(0);
+    commit();
+  }
+
+  void commit() {
+    delete activeLog();
+    undo = nullptr;
+  }
+
+  // Combined mapped values of the keys in [lo, hi) under the monoid of an
+  // aggregated<Monoid> balance policy, in O(log n). Values written in place
+  // through at(), operator[], iterators or for_each_in_range are seen only
+  // after refresh(key); the other members keep the summaries current.
+  auto aggregate(const Key& lo, const Key& hi) const {
+    static_assert(IsAugmented<Balance>::value,
+                  "aggregate needs an aggregated balance policy");
+    return tree.aggregate(lo, hi);
+  }
+
+  // Content comparison in O(1) for maps with a merkle balance policy: the
+  // root digests are compared, so different contents are reported equal
+  // only on a 64-bit hash collision.
+  bool same_contents(const map& other) const {
+    return content_digest() == other.content_digest();
+  }
+
+  merkle_digest content_digest() const {
+    static_assert(IsMerkle<Balance>::value,
+                  "content digests need a merkle balance policy");
+    return tree.empty() ? merkle_digest() : tree.getRoot()->fields.summary;
+  }
+
+  // Updates that turn other into a copy of this map, to be passed to
+  // other.apply_batch. Subtrees whose digests match are skipped, so the
+  // cost follows the number of differing keys rather than the map size.
+  std::vector<update_type> diff(const map& other) const {
+    static_assert(IsMerkle<Balance>::value,
+                  "diff needs a merkle balance policy");
+    std::vector<update_type> updates;
+    tree.diffAgainst(other.tree, [&](const value_type* mine,
+                                       const value_type* theirs) {
+      if (mine != nullptr) {
+        updates.push_back({batch_op::insert, *mine});
+      } else {
+        updates.push_back({batch_op::erase, *theirs});
+      }
+    });
+    return updates;
+  }
+
+  void refresh(const Key& key) {
+    Node* node = tree.search(key);
+    if (node != nullptr) tree.refreshPath(node);
+  }
+
+  // Incremental checkpoints: enable_checkpoints writes a base image of the
+  // map to path, and each checkpoint() appends to path.delta only the keys
+  // changed since the previous one, found through the same hooks as the
+  // transaction log. compact_checkpoints folds the deltas into the base
+  // image, by default on a background thread. recover rebuilds a map from
+  // the files with one O(n) bulk build plus a batch for the deltas.
+  // Keys and values are encoded with checkpoint_codec.
+  // Enabling again first stops the previous checkpointer, whose background
+  // compaction may still be writing the files of the same path.
+  void enable_checkpoints(const std::string& path) {
+    disable_checkpoints();
+    checkpointer* files = new checkpointer(path, key_comp());
+    try {
+      files->writeBase(begin(), end());
+    } catch (...) {
+      delete files;
+      throw;
+    }
+    checkpoints = files;
+  }
+
+  void disable_checkpoints() {
+    delete checkpoints;
+    checkpoints = nullptr;
+  }
+
+  bool checkpoints_enabled() const noexcept { return checkpoints != nullptr; }
+
+  // Returns the number of keys written.
+  size_type checkpoint() {
+    return activeCheckpoints()->writeDelta([this](const Key& key) {
+      Node* node = tree.search(key);
+      return node != nullptr ? &node->data.second : nullptr;
+    });
+  }
+
+  void compact_checkpoints(bool background = true) {
+    activeCheckpoints()->compact(background);
+  }
+
+  // Blocks until a background compaction is done and rethrows its error.
+  void wait_for_checkpoints() { activeCheckpoints()->waitForCompaction(); }
+
+  // The recovered map keeps checkpointing to the same files. It starts
+  // them over from a base image of what was read: replay stops at a record
+  // torn by a crash, so checkpoints appended behind it would be lost.
+  static map recover(const std::string& path,
+                     const Compare& comp = Compare()) {
+    std::vector<update_type> base;
+    std::vector<update_type> changes;
+    checkpointer::load(path, base, changes);
+    map result(comp);
+    result.tree.applySorted(base);
+    result.tree.applyBatch(std::move(changes));
+    result.checkpoints = new checkpointer(path, result.key_comp());
+    result.checkpoints->writeBase(result.begin(), result.end());
+    return result;
+  }
+
+  // Non-throwing lookups: find() returns end(), try_get() returns nullptr
+  // and get_or() returns the fallback for an absent key.
+  iterator find(const Key& key) {
+    return iterator(findNode(key), tree.getRoot());
+  }
+
+  T* try_get(const Key& key) {
+    Node* node = findNode(key);
+    return node != nullptr ? &node->data.second : nullptr;
+  }
+
+  const T* try_get(const Key& key) const {
+    Node* node = findNode(key);
+    return node != nullptr ? &node->data.second : nullptr;
+  }
+
+  T get_or(const Key& key, const T& fallback) const {
+    Node* node = findNode(key);
+    return node != nullptr ? node->data.second : fallback;
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K& key) {
+    return tree.containsPair(key);
+  }
+
+  key_compare key_comp() const { return tree.keyCompare(); }
+
+  value_compare value_comp() const { return value_compare(tree.keyCompare()); }
+
+  // Puts a Bloom filter sized for the current contents in front of contains
+  // so that most lookups of absent keys skip the tree walk.
+  void enable_bloom_filter(double false_positive_rate = 0.01) {
+    static_assert(IsHashable<Key, std::hash<Key>>::value,
+                  "Bloom filter requires std::hash<Key>");
+    bloom_stats stats = bloom_filter_stats();
+    delete bloom;
+    bloom = nullptr;
+    bloom = new BloomFilter<Key>(size(), false_positive_rate);
+    bloom->setStats(stats);
+    for (auto it = begin(); it != end(); ++it) bloom->insert((*it).first);
+  }
+
+  void disable_bloom_filter() {
+    delete bloom;
+    bloom = nullptr;
+  }
+
+  bool bloom_filter_enabled() const noexcept { return bloom != nullptr; }
+
+  // Erased keys stay in the filter as false positives until it is rebuilt.
+  void rebuild_bloom_filter() {
+    if (bloom != nullptr) rebuildBloom(size());
+  }
+
+  bloom_stats bloom_filter_stats() const noexcept {
+    return bloom != nullptr ? bloom->stats() : bloom_stats();
+  }
+
+  // Caches recently found elements by key hash so that repeated lookups of
+  // hot keys skip the tree descent. With evenly spread keys it mostly misses
+  // and adds a hash per lookup; bench_lookup_cache.cc times both cases.
+  void enable_lookup_cache(size_type slots = 1024) {
+    static_assert(IsHashable<Key, std::hash<Key>>::value,
+                  "lookup cache requires std::hash<Key>");
+    delete cache;
+    cache = nullptr;
+    cache = new LookupCache<Node>(slots);
+  }
+
+  void disable_lookup_cache() {
+    delete cache;
+    cache = nullptr;
+  }
+
+  bool lookup_cache_enabled() const noexcept { return cache != nullptr; }
+
+  cache_stats lookup_cache_stats() const noexcept {
+    return cache != nullptr ? cache->stats() : cache_stats();
+  }
 
   template <typename... Args>
   std::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
@@ -124,7 +561,142 @@ class map {
   }
 
  private:
-  BinaryTree<key_type, value_type, mapCompare>* tree;
+  static std::uint64_t keyHash(const Key& key) {
+    if constexpr (IsHashable<Key, std::hash<Key>>::value) {
+      return std::hash<Key>()(key);
+    } else {
+      (void)key;
+      return 0;
+    }
+  }
+
+  // Lookup path shared by every key lookup: the hot-key cache first, then
+  // the Bloom filter, then the tree.
+  Node* findNode(const Key& key) const {
+    std::uint64_t hash = 0;
+    if (cache != nullptr) {
+      hash = keyHash(key);
+      if (Node* cached = cachedNode(key, hash)) return cached;
+    }
+    if (bloom != nullptr && !bloom->admit(key)) return nullptr;
+    Node* node = tree.search(key);
+    if (bloom != nullptr) bloom->recordResult(node != nullptr);
+    if (node != nullptr && cache != nullptr) cache->store(hash, node);
+    return node;
+  }
+
+  Node* cachedNode(const Key& key, std::uint64_t hash) const {
+    const Compare& comp = tree.keyCompare();
+    return cache->find(hash, [&](const Node& node) {
+      return !comp(node.data.first, key) && !comp(key, node.data.first);
+    });
+  }
+
+  std::pair<iterator, bool> insertValue(const value_type& value) {
+    std::pair<iterator, bool> result = tree.insertUnique(value);
+    if (result.second) {
+      noteInserted(value.first);
+      logChange(change::inserted, value);
+    }
+    return result;
+  }
+
+  // Find-or-create in a single descent: a cached or found element is
+  // returned as is, make() builds the element only on the insert path. The
+  // Bloom filter is skipped because an absent key is inserted anyway.
+  template <typename Make>
+  std::pair<iterator, bool> emplaceKey(const Key& key, Make&& make) {
+    std::uint64_t hash = 0;
+    if (cache != nullptr) {
+      hash = keyHash(key);
+      if (Node* cached = cachedNode(key, hash)) {
+        return {iterator(cached, tree.getRoot()), false};
+      }
+    }
+    std::pair<iterator, bool> result = tree.emplaceUnique(key, make);
+    if (result.second) {
+      noteInserted(key);
+      logChange(change::inserted, *result.first);
+    } else if (cache != nullptr) {
+      cache->store(hash, result.first.iter);
+    }
+    return result;
+  }
+
+  void noteInserted(const Key& key) {
+    if (bloom == nullptr) return;
+    bloom->insert(key);
+    if (bloom->overloaded()) rebuildBloom(bloom->capacity() * 2);
+  }
+
+  undo_log* activeLog() const {
+    if (undo == nullptr) throw std::logic_error("no open transaction");
+    return undo;
+  }
+
+  checkpointer* activeCheckpoints() const {
+    if (checkpoints == nullptr) throw std::logic_error("no checkpoints");
+    return checkpoints;
+  }
+
+  // Every modifier of the map calls this before changing an element: the
+  // transaction log records how to undo the change and the checkpoint
+  // files mark its key dirty. Accessors do not, and writes through the
+  // references and iterators they hand out go unrecorded; see at().
+  void logChange(change kind, const value_type& value) {
+    if (undo != nullptr) undo->record(kind, value);
+    if (checkpoints != nullptr) checkpoints->noteDirty(value.first);
+  }
+
+  void logAll(change kind) {
+    if (undo == nullptr && checkpoints == nullptr) return;
+    for (auto it = begin(); it != end(); ++it) logChange(kind, *it);
+  }
+
+  // Marks each key dirty and logs each update against the state before the
+  // batch. Repeated keys may log more than is applied; undoing a change
+  // that did not happen is a no-op.
+  void logBatch(const std::vector<update_type>& updates) {
+    for (const update_type& update : updates) {
+      if (checkpoints != nullptr) checkpoints->noteDirty(update.value.first);
+      if (undo == nullptr) continue;
+      Node* node = tree.search(update.value.first);
+      if (node != nullptr) {
+        bool isErase = update.op == batch_op::erase;
+        undo->record(isErase ? change::erased : change::assigned, node->data);
+      } else if (update.op == batch_op::insert) {
+        undo->record(change::inserted, update.value);
+      }
+    }
+  }
+
+  void undoChange(change kind, const value_type& value) {
+    Node* node = tree.search(value.first);
+    if (kind == change::inserted) {
+      if (node != nullptr) erase(iterator(node, tree.getRoot()));
+    } else if (kind == change::erased) {
+      if (node == nullptr) insertValue(value);
+    } else if (node != nullptr) {
+      node->data.second = value.second;
+      tree.refreshPath(node);
+    }
+  }
+
+  void rebuildBloom(size_type capacity) {
+    BloomFilter<Key>* rebuilt =
+        new BloomFilter<Key>(capacity, bloom->fp_rate());
+    rebuilt->setStats(bloom->stats());
+    for (auto it = begin(); it != end(); ++it) rebuilt->insert((*it).first);
+    delete bloom;
+    bloom = rebuilt;
+  }
+
+  tree_type tree;
+  bool backgroundReclaim = false;
+  BloomFilter<Key>* bloom = nullptr;
+  LookupCache<Node>* cache = nullptr;
+  undo_log* undo = nullptr;
+  checkpointer* checkpoints = nullptr;
 };
 
 }  // namespace s21
@@ -0,0 +1,487 @@
+#ifndef S21_CONTAINERS_MULTI_INDEX_H
+#define S21_CONTAINERS_MULTI_INDEX_H
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_binary_tree.h"
+
+namespace s21 {
+template <typename Member>
+struct MemberKey;
+
+template <typename Element, typename Key>
+struct MemberKey<Key Element::*> {
+  using key_type = Key;
+};
+
+// Index specifications for multi_index, each keyed by a data member of the
+// element type: ordered indices are AVL trees, hashed ones chained hash
+// tables. Unique indices reject an element whose key is already present.
+template <auto Member,
+          typename Compare =
+              std::less<typename MemberKey<decltype(Member)>::key_type>>
+struct ordered_unique {
+  using key_type = typename MemberKey<decltype(Member)>::key_type;
+  using key_compare = Compare;
+  static constexpr bool ordered = true;
+  static constexpr bool unique = true;
+
+  template <typename Element>
+  static const key_type &key(const Element &element) noexcept {
+    return element.*Member;
+  }
+};
+
+template <auto Member,
+          typename Compare =
+              std::less<typename MemberKey<decltype(Member)>::key_type>>
+struct ordered_non_unique : ordered_unique<Member, Compare> {
+  static constexpr bool unique = false;
+};
+
+template <auto Member, typename Hash = std::hash<
+                           typename MemberKey<decltype(Member)>::key_type>>
+struct hashed_unique {
+  using key_type = typename MemberKey<decltype(Member)>::key_type;
+  using hasher = Hash;
+  static constexpr bool ordered = false;
+  static constexpr bool unique = true;
+
+  template <typename Element>
+  static const key_type &key(const Element &element) noexcept {
+    return element.*Member;
+  }
+};
+
+template <auto Member, typename Hash = std::hash<
+                           typename MemberKey<decltype(Member)>::key_type>>
+struct hashed_non_unique : hashed_unique<Member, Hash> {
+  static constexpr bool unique = false;
+};
+
+// Ordered view over the elements of a multi_index: a tree of pointers to
+// the shared elements, keyed through the index's member.
+template <typename Element, typename Spec>
+class OrderedIndex {
+ public:
+  using key_type = typename Spec::key_type;
+  using key_compare = typename Spec::key_compare;
+  using size_type = std::size_t;
+
+  struct Entry {
+    const Element *element = nullptr;
+    const key_type &key() const noexcept { return Spec::key(*element); }
+  };
+
+  using tree_type = BinaryTree<key_type, Entry, key_compare>;
+  using Node = typename tree_type::Node;
+
+  class iterator {
+   public:
+    iterator(const Node *node_, const tree_type *tree_)
+        : node(node_), tree(tree_) {}
+
+    const Element &operator*() const { return *node->data.element; }
+    const Element *operator->() const { return node->data.element; }
+
+    iterator &operator++() {
+      node = node->moveForward();
+      return *this;
+    }
+
+    iterator &operator--() {
+      node = (node == nullptr) ? tree->getRoot()->getMax() : node->moveBack();
+      return *this;
+    }
+
+    bool operator==(const iterator &other) const noexcept {
+      return node == other.node;
+    }
+
+    bool operator!=(const iterator &other) const noexcept {
+      return node != other.node;
+    }
+
+   private:
+    const Node *node;
+    const tree_type *tree;
+  };
+
+  using const_iterator = iterator;
+
+  iterator begin() const { return iterator(tree.minNode(), &tree); }
+  iterator end() const { return iterator(nullptr, &tree); }
+
+  size_type size() const noexcept { return tree.size(); }
+  bool empty() const noexcept { return tree.empty(); }
+
+  // For non-unique indices, the first element with the key.
+  iterator find(const key_type &key) const {
+    iterator it = lower_bound(key);
+    if (it == end() || tree.keyCompare()(key, Spec::key(*it))) return end();
+    return it;
+  }
+
+  iterator lower_bound(const key_type &key) const {
+    return iterator(tree.findLowerBound(key).iter, &tree);
+  }
+
+  iterator upper_bound(const key_type &key) const {
+    return iterator(tree.findUpperBound(key).iter, &tree);
+  }
+
+  std::pair<iterator, iterator> equal_range(const key_type &key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  size_type count(const key_type &key) const { return tree.count(key); }
+
+  bool contains(const key_type &key) const { return tree.contains(key); }
+
+  const key_compare &key_comp() const noexcept { return tree.keyCompare(); }
+
+ private:
+  template <typename, typename...>
+  friend class multi_index;
+
+  const Element *conflict(const Element &element) const {
+    if (!Spec::unique) return nullptr;
+    Node *node = tree.search(Spec::key(element));
+    return node != nullptr ? node->data.element : nullptr;
+  }
+
+  void insert(const Element *element) {
+    tree.insert(Entry{element}, Spec::unique);
+  }
+
+  // Equal keys are adjacent, so the element's own node is found by walking
+  // forward from the first node with its key.
+  void erase(const Element *element) {
+    Node *node = tree.findLowerBound(Spec::key(*element)).iter;
+    while (node->data.element != element) node = node->moveForward();
+    tree.erase(typename tree_type::iterator(node, tree.getRoot()));
+  }
+
+  void clear() { tree.clearTree(); }
+
+  template <typename Fn>
+  void forEach(Fn fn) const {
+    for (const Node *n = tree.minNode(); n != nullptr; n = n->moveForward()) {
+      fn(n->data.element);
+    }
+  }
+
+  tree_type tree;
+};
+
+// Hashed view over the elements of a multi_index. Buckets are vectors of
+// element pointers in which equal keys are kept next to each other, so
+// equal_range is a contiguous slice of one bucket.
+template <typename Element, typename Spec>
+class HashedIndex {
+ public:
+  using key_type = typename Spec::key_type;
+  using hasher = typename Spec::hasher;
+  using size_type = std::size_t;
+
+  class iterator {
+   public:
+    explicit iterator(const Element *const *position_) : position(position_) {}
+
+    const Element &operator*() const { return **position; }
+    const Element *operator->() const { return *position; }
+
+    iterator &operator++() {
+      ++position;
+      return *this;
+    }
+
+    bool operator==(const iterator &other) const noexcept {
+      return position == other.position;
+    }
+
+    bool operator!=(const iterator &other) const noexcept {
+      return position != other.position;
+    }
+
+   private:
+    const Element *const *position;
+  };
+
+  using const_iterator = iterator;
+
+  size_type size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  // Returned by find() for an absent key.
+  iterator end() const { return iterator(nullptr); }
+
+  iterator find(const key_type &key) const {
+    auto range = equal_range(key);
+    return range.first == range.second ? end() : range.first;
+  }
+
+  std::pair<iterator, iterator> equal_range(const key_type &key) const {
+    if (buckets.empty()) return {end(), end()};
+    const std::vector<const Element *> &bucket = buckets[bucketOf(key)];
+    size_type first = 0;
+    while (first < bucket.size() && !(Spec::key(*bucket[first]) == key)) {
+      ++first;
+    }
+    size_type last = first;
+    while (last < bucket.size() && Spec::key(*bucket[last]) == key) ++last;
+    if (first == last) return {end(), end()};
+    return {iterator(bucket.data() + first), iterator(bucket.data() + last)};
+  }
+
+  size_type count(const key_type &key) const {
+    size_type result = 0;
+    auto range = equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) ++result;
+    return result;
+  }
+
+  bool contains(const key_type &key) const { return find(key) != end(); }
+
+  size_type bucket_count() const noexcept { return buckets.size(); }
+
+ private:
+  template <typename, typename...>
+  friend class multi_index;
+
+  size_type bucketOf(const key_type &key) const {
+    return hasher()(key) & (buckets.size() - 1);
+  }
+
+  const Element *conflict(const Element &element) const {
+    if (!Spec::unique) return nullptr;
+    iterator it = find(Spec::key(element));
+    return it != end() ? &*it : nullptr;
+  }
+
+  void insert(const Element *element) {
+    if (size_ + 1 > buckets.size()) {
+      rehash(buckets.empty() ? 16 : 2 * buckets.size());
+    }
+    place(buckets[bucketOf(Spec::key(*element))], element);
+    ++size_;
+  }
+
+  void erase(const Element *element) {
+    std::vector<const Element *> &bucket =
+        buckets[bucketOf(Spec::key(*element))];
+    for (size_type i = 0; i < bucket.size(); ++i) {
+      if (bucket[i] == element) {
+        bucket.erase(bucket.begin() + i);
+        --size_;
+        return;
+      }
+    }
+  }
+
+  void clear() {
+    buckets.clear();
+    size_ = 0;
+  }
+
+  template <typename Fn>
+  void forEach(Fn fn) const {
+    for (const auto &bucket : buckets) {
+      for (const Element *element : bucket) fn(element);
+    }
+  }
+
+  static void place(std::vector<const Element *> &bucket,
+                    const Element *element) {
+    const key_type &key = Spec::key(*element);
+    size_type position = bucket.size();
+    for (size_type i = 0; i < bucket.size(); ++i) {
+      if (Spec::key(*bucket[i]) == key) {
+        position = i + 1;
+        while (position < bucket.size() &&
+               Spec::key(*bucket[position]) == key) {
+          ++position;
+        }
+        break;
+      }
+    }
+    bucket.insert(bucket.begin() + position, element);
+  }
+
+  // Builds the new table aside, so a throwing hasher or allocation leaves
+  // the index as it was.
+  void rehash(size_type count) {
+    std::vector<std::vector<const Element *>> rebuilt(count);
+    for (const auto &bucket : buckets) {
+      for (const Element *element : bucket) {
+        place(rebuilt[hasher()(Spec::key(*element)) & (count - 1)], element);
+      }
+    }
+    buckets.swap(rebuilt);
+  }
+
+  std::vector<std::vector<const Element *>> buckets;
+  size_type size_ = 0;
+};
+
+template <typename Element, typename Spec>
+using IndexFor =
+    typename std::conditional<Spec::ordered, OrderedIndex<Element, Spec>,
+                              HashedIndex<Element, Spec>>::type;
+
+// Container that stores each element once and keeps it in every listed
+// index. get<N>() returns the N-th index, with the usual lookup interface.
+// Elements are read-only through the indices, since changing a key in place
+// would break them; erase and re-insert instead.
+template <typename Element, typename... Indices>
+class multi_index {
+ public:
+  using value_type = Element;
+  using size_type = std::size_t;
+
+  static_assert(sizeof...(Indices) > 0, "multi_index needs an index");
+
+  multi_index() = default;
+
+  // The destructor does not run for a constructor that throws, so the
+  // elements inserted so far are freed before the exception propagates.
+  multi_index(std::initializer_list<value_type> const &items) {
+    try {
+      for (const auto &item : items) insert(item);
+    } catch (...) {
+      clear();
+      throw;
+    }
+  }
+
+  multi_index(const multi_index &other) {
+    try {
+      std::get<0>(other.indices).forEach(
+          [this](const Element *element) { insert(*element); });
+    } catch (...) {
+      clear();
+      throw;
+    }
+  }
+
+  multi_index(multi_index &&other)
+      : indices(std::move(other.indices)),
+        size_(std::exchange(other.size_, 0)) {}
+
+  multi_index &operator=(const multi_index &other) {
+    if (this != &other) {
+      multi_index copy(other);
+      swap(copy);
+    }
+    return *this;
+  }
+
+  multi_index &operator=(multi_index &&other) {
+    if (this != &other) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  ~multi_index() { clear(); }
+
+  template <std::size_t N>
+  auto &get() noexcept {
+    return std::get<N>(indices);
+  }
+
+  template <std::size_t N>
+  const auto &get() const noexcept {
+    return std::get<N>(indices);
+  }
+
+  size_type size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  std::pair<const Element *, bool> insert(const value_type &value) {
+    return emplace(value);
+  }
+
+  // All unique indices are checked before any index is touched: the
+  // element goes into every index or into none. On a clash the existing
+  // element is returned. If an index throws, for instance from its
+  // comparator, hasher or an allocation, the indices already updated are
+  // rolled back before the exception propagates.
+  template <typename... Args>
+  std::pair<const Element *, bool> emplace(Args &&...args) {
+    Element *element = new Element(std::forward<Args>(args)...);
+    const Element *existing = nullptr;
+    size_type updated = 0;
+    try {
+      existing = findConflict(*element);
+      if (existing == nullptr) {
+        std::apply(
+            [&](auto &...index) {
+              ((index.insert(element), ++updated), ...);
+            },
+            indices);
+      }
+    } catch (...) {
+      std::apply(
+          [&](auto &...index) {
+            size_type position = 0;
+            ((position++ < updated ? index.erase(element) : void()), ...);
+          },
+          indices);
+      delete element;
+      throw;
+    }
+    if (existing != nullptr) {
+      delete element;
+      return {existing, false};
+    }
+    ++size_;
+    return {element, true};
+  }
+
+  // element must be a reference obtained from one of the indices.
+  void erase(const Element &element) {
+    std::apply([&](auto &...index) { (index.erase(&element), ...); },
+               indices);
+    delete &element;
+    --size_;
+  }
+
+  void clear() {
+    std::vector<const Element *> elements;
+    elements.reserve(size_);
+    std::get<0>(indices).forEach(
+        [&](const Element *element) { elements.push_back(element); });
+    std::apply([](auto &...index) { (index.clear(), ...); }, indices);
+    for (const Element *element : elements) delete element;
+    size_ = 0;
+  }
+
+  void swap(multi_index &other) {
+    std::swap(indices, other.indices);
+    std::swap(size_, other.size_);
+  }
+
+ private:
+  const Element *findConflict(const Element &element) const {
+    const Element *existing = nullptr;
+    std::apply(
+        [&](const auto &...index) {
+          ((existing = existing ? existing : index.conflict(element)), ...);
+        },
+        indices);
+    return existing;
+  }
+
+  std::tuple<IndexFor<Element, Indices>...> indices;
+  size_type size_ = 0;
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_MULTI_INDEX_H
@@ -0,0 +1,219 @@
+#ifndef S21_CONTAINERS_MULTIMAP_H
+#define S21_CONTAINERS_MULTIMAP_H
+
+#include "s21_binary_tree.h"
+#include "s21_small_buffer.h"
+
+namespace s21 {
+// Ordered multimap with one tree node per distinct key. The node holds all
+// values of its key, in insertion order, in a SmallBuffer of InlineValues
+// slots that spills to the heap for larger groups. count() is a single
+// descent and equal_range walks one contiguous buffer. Iterators yield
+// std::pair<const Key&, T&> proxies.
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Balance = avl_balance, std::size_t InlineValues = 2>
+class multimap {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<key_type, mapped_type>;
+  using reference = std::pair<const key_type&, mapped_type&>;
+  using size_type = std::size_t;
+  using key_compare = Compare;
+
+  using group_type = SmallBuffer<mapped_type, InlineValues>;
+  using group_entry = std::pair<key_type, group_type>;
+  using tree_type = BinaryTree<key_type, group_entry, Compare, Balance>;
+  using Node = typename tree_type::Node;
+
+  class iterator {
+   public:
+    struct pointer {
+      reference ref;
+      const reference* operator->() const noexcept { return &ref; }
+    };
+
+    iterator(Node* node_, size_type index_, const tree_type* tree_)
+        : node(node_), index(index_), tree(tree_) {}
+
+    reference operator*() const {
+      return reference(node->data.first, node->data.second[index]);
+    }
+
+    pointer operator->() const { return pointer{**this}; }
+
+    iterator& operator++() {
+      if (++index == node->data.second.size()) {
+        node = node->moveForward();
+        index = 0;
+      }
+      return *this;
+    }
+
+    iterator& operator--() {
+      if (node == nullptr) {
+        node = tree->getRoot()->getMax();
+        index = node->data.second.size() - 1;
+      } else if (index > 0) {
+        --index;
+      } else {
+        node = node->moveBack();
+        index = node->data.second.size() - 1;
+      }
+      return *this;
+    }
+
+    bool operator==(const iterator& other) const noexcept {
+      return node == other.node && index == other.index;
+    }
+
+    bool operator!=(const iterator& other) const noexcept {
+      return !(*this == other);
+    }
+
+    Node* node;
+    size_type index;
+    const tree_type* tree;
+  };
+
+  multimap() = default;
+
+  explicit multimap(const Compare& comp) : tree(comp) {}
+
+  multimap(std::initializer_list<value_type> const& items,
+           const Compare& comp = Compare())
+      : tree(comp) {
+    for (auto item : items) {
+      insert(item);
+    }
+  }
+
+  multimap(const multimap& m) : tree(m.tree), elements(m.elements) {}
+
+  multimap(multimap&& m)
+      : tree(std::move(m.tree)), elements(std::exchange(m.elements, 0)) {}
+
+  multimap& operator=(multimap& m) {
+    if (this != &m) {
+      tree = m.tree;
+      elements = m.elements;
+    }
+    return *this;
+  }
+
+  multimap& operator=(multimap&& m) {
+    if (this != &m) {
+      clear();
+      tree = std::move(m.tree);
+      elements = std::exchange(m.elements, 0);
+    }
+    return *this;
+  }
+
+  iterator begin() { return iterator(tree.minNode(), 0, &tree); }
+
+  iterator end() { return iterator(nullptr, 0, &tree); }
+
+  bool empty() { return elements == 0; }
+
+  size_type size() { return elements; }
+
+  // Number of distinct keys, i.e. tree nodes.
+  size_type key_count() { return tree.size(); }
+
+  size_type max_size() {
+    return (std::numeric_limits<size_type>::max() / 2) / sizeof(Node);
+  }
+
+  // Appends to the key's group, so equal keys keep insertion order. A key
+  // already present costs one descent and no node allocation.
+  iterator insert(const value_type& value) {
+    return insert(value.first, value.second);
+  }
+
+  iterator insert(const Key& key, const T& obj) {
+    Node* node =
+        tree.emplaceUnique(key, [&] { return group_entry(key, group_type()); })
+            .first.iter;
+    node->data.second.push_back(obj);
+    ++elements;
+    return iterator(node, node->data.second.size() - 1, &tree);
+  }
+
+  // Removes one value; the key's node goes with its last value.
+  void erase(iterator pos) {
+    group_type& group = pos.node->data.second;
+    if (group.size() == 1) {
+      tree.erase(typename tree_type::iterator(pos.node, tree.getRoot()));
+    } else {
+      group.erase(pos.index);
+    }
+    --elements;
+  }
+
+  size_type erase(const Key& key) {
+    Node* node = tree.search(key);
+    if (node == nullptr) return 0;
+    size_type removed = node->data.second.size();
+    tree.erase(typename tree_type::iterator(node, tree.getRoot()));
+    elements -= removed;
+    return removed;
+  }
+
+  void swap(multimap& other) {
+    tree.swap(other.tree);
+    std::swap(elements, other.elements);
+  }
+
+  void clear() {
+    tree.clearTree();
+    elements = 0;
+  }
+
+  void merge(multimap& other) {
+    for (auto it = other.begin(); it != other.end(); ++it) {
+      insert(it->first, it->second);
+    }
+    other.clear();
+  }
+
+  size_type count(const Key& key) {
+    Node* node = tree.search(key);
+    return node != nullptr ? node->data.second.size() : 0;
+  }
+
+  bool contains(const Key& key) { return tree.contains(key); }
+
+  // First value of the key, or end().
+  iterator find(const Key& key) { return iterator(tree.search(key), 0, &tree); }
+
+  iterator lower_bound(const Key& key) {
+    return iterator(tree.findLowerBound(key).iter, 0, &tree);
+  }
+
+  iterator upper_bound(const Key& key) {
+    return iterator(tree.findUpperBound(key).iter, 0, &tree);
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key& key) {
+    Node* node = tree.search(key);
+    if (node == nullptr) return {end(), end()};
+    return {iterator(node, 0, &tree), iterator(node->moveForward(), 0, &tree)};
+  }
+
+  // The values of the key as one contiguous array, or null when absent.
+  const group_type* values(const Key& key) {
+    Node* node = tree.search(key);
+    return node != nullptr ? &node->data.second : nullptr;
+  }
+
+  key_compare key_comp() const { return tree.keyCompare(); }
+
+ private:
+  tree_type tree;
+  size_type elements = 0;
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_MULTIMAP_H
@@ -4,7 +4,8 @@
 #include "s21_binary_tree.h"
 
 namespace s21 {
-template <typename Key>
+template <typename Key, typename Compare = std::less<Key>,
+          typename Balance = avl_balance>
 class multiset {
  public:
   using key_type = Key;
@@ -13,79 +14,101 @@ class multiset {
   using const_reference = const value_type&;
   using size_type = std::size_t;
 
-  struct multisetCompare {
-    bool operator()(const value_type& a, const value_type& b) const noexcept {
-      return a < b;
-    }
-  };
+  using key_compare = Compare;
+  using value_compare = Compare;
+  using tree_type = BinaryTree<key_type, value_type, Compare, Balance>;
+
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using Node = typename tree_type::Node;
 
-  using iterator =
-      typename BinaryTree<key_type, value_type, multisetCompare>::iterator;
-  using const_iterator = typename BinaryTree<key_type, value_type,
-                                             multisetCompare>::const_iterator;
-  using Node = typename BinaryTree<key_type, value_type, multisetCompare>::Node;
+  multiset() = default;
 
-  multiset() : tree(new BinaryTree<key_type, value_type, multisetCompare>) {}
+  explicit multiset(const Compare& comp) : tree(comp) {}
 
-  multiset(std::initializer_list<value_type> const& items)
-      : tree(new BinaryTree<value_type, value_type, multisetCompare>()) {
+  multiset(std::initializer_list<value_type> const& items,
+           const Compare& comp = Compare())
+      : tree(comp) {
     for (auto item : items) {
       insert(item);
     }
   }
 
-  multiset(const multiset& ms) : tree(new BinaryTree<value_type, value_type, multisetCompare>(*ms.tree)) {}
+  multiset(const multiset& ms) : tree(ms.tree) {}
 
-  multiset(multiset&& ms) : tree(new BinaryTree<value_type, value_type, multisetCompare>(std::move(*ms.tree))) {}
+  multiset(multiset&& ms) : tree(std::move(ms.tree)) {}
 
   multiset& operator=(multiset& ms) {
-    *tree = *ms.tree;
+    tree = ms.tree;
     return *this;
   }
 
+  // The reclaim setting stays with each multiset.
   multiset& operator=(multiset&& ms) {
-    clear();
-    *tree = std::move(*ms.tree);
+    if (this != &ms) {
+      clear();
+      tree = std::move(ms.tree);
+    }
     return *this;
   }
 
   ~multiset() {
-    delete tree;
-    tree = nullptr;
+    tree.deleteTree(backgroundReclaim);
   }
 
-  bool empty() { return tree->empty(); }
+  bool empty() { return tree.empty(); }
 
-  size_type size() { return tree->size(); }
+  size_type size() { return tree.size(); }
 
   size_type max_size() {
     return (std::numeric_limits<size_type>::max() / 2) / sizeof(Node);
   }
 
-  iterator begin() { return iterator(tree->minNode(), tree->getRoot()); }
+  iterator begin() { return iterator(tree.minNode(), tree.getRoot()); }
 
-  iterator end() { return iterator(nullptr, tree->getRoot()); }
+  iterator end() { return iterator(nullptr, tree.getRoot()); }
 
   const_iterator cbegin() const noexcept {
-    return const_iterator(tree->minNode(), tree->getRoot());
+    return const_iterator(tree.minNode(), tree.getRoot());
   }
 
   const_iterator cend() const noexcept {
-    return const_iterator(nullptr, tree->getRoot());
+    return const_iterator(nullptr, tree.getRoot());
   }
 
   iterator insert(const value_type& value) {
-    std::pair<iterator, bool> getIter = tree->insertNonUnique(value);
+    std::pair<iterator, bool> getIter = tree.insertNonUnique(value);
     return getIter.first;
   }
 
-  void erase(iterator pos) { tree->erase(pos); }
+  void erase(iterator pos) { tree.erase(pos); }
 
-  bool contains(const Key& key) { return tree->contains(key); }
+  bool contains(const Key& key) { return tree.contains(key); }
 
-  void swap(multiset& other) { std::swap(tree, other.tree); }
+  void swap(multiset& other) { tree.swap(other.tree); }
 
-  void clear() { tree->clearTree(); }
+  void clear() { tree.clearTree(backgroundReclaim); }
+
+  // Opt-in: clear() and the destructor hand the elements to a background
+  // thread and return at once. Element destructors then run on that thread.
+  void set_background_reclaim(bool enabled) noexcept {
+    backgroundReclaim = enabled;
+  }
+
+  bool background_reclaim() const noexcept { return backgroundReclaim; }
+
+  // Shape of the underlying tree plus, when built with
+  // S21_CONTAINERS_STATS, its operation counters. Takes O(n).
+  tree_stats stats() const { return tree.stats(); }
+
+  void reset_counters() noexcept { tree.resetCounters(); }
+
+  // Removes all elements matching pred in one traversal and returns how
+  // many were removed.
+  template <typename Pred>
+  size_type erase_if(Pred pred) {
+    return tree.eraseIf(pred);
+  }
 
   void merge(multiset& other) {
     auto otherEnd = other.end();
@@ -95,30 +118,101 @@ class multiset {
     other.clear();
   }
 
+  // Calls fn on each element with a key in [lo, hi), in key order.
+  template <typename Fn>
+  void for_each_in_range(const Key& lo, const Key& hi, Fn fn) {
+    tree.forEachInRange(lo, hi, [&](const value_type& value) { fn(value); });
+  }
+
+  // Moves all elements into one contiguous block in the given layout to
+  // restore memory locality after churn. Invalidates iterators and element
+  // pointers.
+  void compact(node_layout layout = node_layout::in_order) {
+    tree.compact(layout);
+  }
+
+  // Incremental compaction: begin_compact fixes the order and each
+  // compact_step moves at most max_nodes elements, returning true when done.
+  // Elements moved by a step invalidate their iterators and pointers.
+  void begin_compact(node_layout layout = node_layout::in_order) {
+    tree.beginCompaction(layout);
+  }
+
+  bool compact_step(size_type max_nodes) {
+    return tree.compactStep(max_nodes);
+  }
+
   std::pair<iterator, iterator> equal_range(const Key& key) {
     return std::make_pair(lower_bound(key), upper_bound(key));
   }
 
-  iterator lower_bound(const Key& key) { return tree->findLowerBound(key); }
+  iterator lower_bound(const Key& key) { return tree.findLowerBound(key); }
+
+  iterator upper_bound(const Key& key) { return tree.findUpperBound(key); }
+
+  // Lookups never throw: find() returns end() and try_get() returns
+  // nullptr for an absent key.
+  iterator find(const Key& key) { return tree.find(key); }
+
+  const value_type* try_get(const Key& key) {
+    Node* node = tree.search(key);
+    return node != nullptr ? &node->data : nullptr;
+  }
 
-  iterator upper_bound(const Key& key) { return tree->findUpperBound(key); }
+  value_type get_or(const Key& key, const value_type& fallback) {
+    Node* node = tree.search(key);
+    return node != nullptr ? node->data : fallback;
+  }
+
+  size_type count(const Key& key) { return tree.count(key); }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator find(const K& key) {
+    return tree.find(key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K& key) {
+    return tree.contains(key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_type count(const K& key) {
+    return tree.count(key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator lower_bound(const K& key) {
+    return tree.findLowerBound(key);
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator upper_bound(const K& key) {
+    return tree.findUpperBound(key);
+  }
 
-  iterator find(const Key& key) { return tree->find(key); }
+  key_compare key_comp() const { return tree.keyCompare(); }
 
-  size_type count(const Key& key) { return tree->count(key); }
+  value_compare value_comp() const { return tree.keyCompare(); }
 
   template <typename... Args>
   std::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
     std::vector<std::pair<iterator, bool>> result;
     std::vector<value_type> arguments = {args...};
     for (auto& elem : arguments) {
-      result.push_back(tree->insertNonUnique(elem));
+      result.push_back(tree.insertNonUnique(elem));
     }
     return result;
   }
 
  private:
-  BinaryTree<Key, Key, multisetCompare>* tree;
+  tree_type tree;
+  bool backgroundReclaim = false;
 };
 
 }  // namespace s21
@@ -0,0 +1,126 @@
+#ifndef S21_CONTAINERS_NODE_ARENA_H
+#define S21_CONTAINERS_NODE_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+// Contiguous blocks that tree compaction relocates nodes into. A block is
+// filled front to back while it is open and returned to the heap once it is
+// closed and its last node has been destroyed. Nodes outside every block
+// belong to the ordinary heap.
+template <typename Node>
+class NodeArena {
+ public:
+  using size_type = std::size_t;
+
+  NodeArena() = default;
+  NodeArena(const NodeArena &) = delete;
+  NodeArena &operator=(const NodeArena &) = delete;
+
+  NodeArena(NodeArena &&other) noexcept
+      : blocks_(std::move(other.blocks_)), open_(other.open_) {
+    other.blocks_.clear();
+    other.open_ = kNone;
+  }
+
+  NodeArena &operator=(NodeArena &&other) noexcept {
+    if (this != &other) {
+      releaseAll();
+      blocks_ = std::move(other.blocks_);
+      open_ = std::exchange(other.open_, kNone);
+      other.blocks_.clear();
+    }
+    return *this;
+  }
+
+  // All nodes must have been destroyed by the owner.
+  ~NodeArena() { releaseAll(); }
+
+  void openBlock(size_type capacity) {
+    closeBlock();
+    Block block;
+    block.begin = std::allocator<Node>().allocate(capacity);
+    block.capacity = capacity;
+    open_ = blockAfter(block.begin);
+    blocks_.insert(blocks_.begin() + open_, block);
+  }
+
+  // Storage for the next node of the open block, or null when it is full.
+  Node *nextSlot() noexcept {
+    if (open_ == kNone) return nullptr;
+    Block &block = blocks_[open_];
+    if (block.used == block.capacity) return nullptr;
+    ++block.live;
+    return block.begin + block.used++;
+  }
+
+  void closeBlock() noexcept {
+    if (open_ == kNone) return;
+    size_type index = std::exchange(open_, kNone);
+    if (blocks_[index].live == 0) freeBlock(index);
+  }
+
+  // Destroys an arena node and returns true, or returns false for a heap
+  // node, which the caller deletes. Blocks are kept in address order, so
+  // the owning block is found by binary search.
+  bool destroy(Node *node) noexcept {
+    size_type next = blockAfter(node);
+    if (next == 0) return false;
+    size_type i = next - 1;
+    Block &block = blocks_[i];
+    if (node >= block.begin + block.capacity) return false;
+    node->~Node();
+    if (--block.live == 0 && i != open_) freeBlock(i);
+    return true;
+  }
+
+  // True once every block has been returned to the heap.
+  bool empty() const noexcept { return blocks_.empty(); }
+
+  size_type blocks() const noexcept { return blocks_.size(); }
+
+ private:
+  static constexpr size_type kNone = static_cast<size_type>(-1);
+
+  struct Block {
+    Node *begin = nullptr;
+    size_type capacity = 0;
+    size_type used = 0;
+    size_type live = 0;
+  };
+
+  // Index of the first block starting above node.
+  size_type blockAfter(const Node *node) const noexcept {
+    return std::upper_bound(blocks_.begin(), blocks_.end(), node,
+                            [](const Node *p, const Block &block) {
+                              return p < block.begin;
+                            }) -
+           blocks_.begin();
+  }
+
+  void freeBlock(size_type index) noexcept {
+    std::allocator<Node>().deallocate(blocks_[index].begin,
+                                      blocks_[index].capacity);
+    blocks_.erase(blocks_.begin() + index);
+    if (open_ != kNone && open_ > index) --open_;
+  }
+
+  void releaseAll() noexcept {
+    for (Block &block : blocks_) {
+      std::allocator<Node>().deallocate(block.begin, block.capacity);
+    }
+    blocks_.clear();
+    open_ = kNone;
+  }
+
+  std::vector<Block> blocks_;
+  size_type open_ = kNone;
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_NODE_ARENA_H
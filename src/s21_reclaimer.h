@@ -0,0 +1,80 @@
+#ifndef S21_CONTAINERS_RECLAIMER_H
+#define S21_CONTAINERS_RECLAIMER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace s21 {
+// Process-wide background thread that runs teardown work handed off by
+// containers, so clearing or destroying a large container returns at once.
+// The thread starts with the first submission; pending work is finished
+// before the program exits.
+class Reclaimer {
+ public:
+  static Reclaimer &instance() {
+    static Reclaimer reclaimer;
+    return reclaimer;
+  }
+
+  Reclaimer(const Reclaimer &) = delete;
+  Reclaimer &operator=(const Reclaimer &) = delete;
+
+  ~Reclaimer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    if (worker_.joinable()) worker_.join();
+  }
+
+  void submit(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+      if (!worker_.joinable()) worker_ = std::thread([this] { run(); });
+    }
+    wake_.notify_all();
+  }
+
+  // Blocks until everything submitted so far has been reclaimed.
+  void drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return tasks_.empty() && running_ == 0; });
+  }
+
+ private:
+  Reclaimer() = default;
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      wake_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) return;
+      std::function<void()> task = std::move(tasks_.front());
+      tasks_.pop_front();
+      ++running_;
+      lock.unlock();
+      task();
+      lock.lock();
+      --running_;
+      if (tasks_.empty()) idle_.notify_all();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable idle_;
+  std::deque<std::function<void()>> tasks_;
+  int running_ = 0;
+  bool stop_ = false;
+  std::thread worker_;
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_RECLAIMER_H
@@ -2,9 +2,12 @@
 #define S21_CONTAINERS_SET_H
 
 #include "s21_binary_tree.h"
+#include "s21_bloom_filter.h"
+#include "s21_undo_log.h"
 
 namespace s21 {
-template <typename Key>
+template <typename Key, typename Compare = std::less<Key>,
+          typename Balance = avl_balance>
 class set {
  public:
   using key_type = Key;
@@ -12,76 +15,136 @@ class set {
   using reference = value_type&;
   using const_reference = const value_type&;
   using size_type = std::size_t;
+  using key_compare = Compare;
+  using value_compare = Compare;
+  using tree_type = BinaryTree<Key, Key, Compare, Balance>;
 
-  struct setCompare {
-    bool operator()(const value_type& a, const value_type& b) const noexcept {
-      return a < b;
-    }
-  };
-
-  using iterator = typename BinaryTree<Key, Key, setCompare>::iterator;
-  using const_iterator =
-      typename BinaryTree<Key, Key, setCompare>::const_iterator;
-  using Node = typename BinaryTree<Key, Key, setCompare>::Node;
+  using update_type = batch_update<value_type>;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using Node = typename tree_type::Node;
+  using bloom_stats = typename BloomFilter<Key>::Stats;
+  using undo_log = UndoLog<value_type>;
+  using change = typename undo_log::change;
 
   // default constructor, creates an empty set
-  set() : tree(new BinaryTree<Key, Key, setCompare>) {}
+  set() = default;
+
+  explicit set(const Compare& comp) : tree(comp) {}
 
-  set(std::initializer_list<value_type> const& items)
-      : tree(new BinaryTree<value_type, value_type, setCompare>()) {
+  set(std::initializer_list<value_type> const& items,
+      const Compare& comp = Compare())
+      : tree(comp) {
     for (auto item : items) {
       insert(item);
     }
   }
 
-  set(const set& s) : tree(new BinaryTree<value_type, value_type, setCompare>(*s.tree)) {}
+  set(const set& s)
+      : tree(s.tree),
+        bloom(s.bloom ? new BloomFilter<Key>(*s.bloom) : nullptr) {}
 
-  set(set&& s) : tree(new BinaryTree<value_type, value_type, setCompare>(std::move(*s.tree))) {}
+  set(set&& s)
+      : tree(std::move(s.tree)),
+        bloom(std::exchange(s.bloom, nullptr)),
+        undo(std::exchange(s.undo, nullptr)) {}
 
+  // Inside a transaction an assignment is logged as erasing every element
+  // and inserting the new ones.
   set& operator=(set& s) {
-    *tree = *s.tree;
+    if (this != &s) {
+      logAll(change::erased);
+      tree = s.tree;
+      logAll(change::inserted);
+      delete bloom;
+      bloom = s.bloom ? new BloomFilter<Key>(*s.bloom) : nullptr;
+    }
     return *this;
   }
 
+  // The elements move; the transaction and reclaim setting stay with
+  // their set. The target logs the move as replacing its elements and the
+  // emptied source logs its elements as erased.
   set& operator=(set&& s) {
-    clear();
-    *tree = std::move(*s.tree);
+    if (this != &s) {
+      clear();
+      s.logAll(change::erased);
+      tree = std::move(s.tree);
+      logAll(change::inserted);
+      std::swap(bloom, s.bloom);
+    }
     return *this;
   }
 
   ~set() {
-    delete tree;
-    tree = nullptr;
+    tree.deleteTree(backgroundReclaim);
+    delete bloom;
+    bloom = nullptr;
+    delete undo;
+    undo = nullptr;
   }
 
-  bool empty() { return tree->empty(); }
+  bool empty() { return tree.empty(); }
 
-  size_type size() { return tree->size(); }
+  size_type size() { return tree.size(); }
 
   size_type max_size() {
     return (std::numeric_limits<size_type>::max() / 2) / sizeof(Node);
   }
 
-  iterator begin() { return iterator(tree->minNode(), tree->getRoot()); }
+  iterator begin() { return iterator(tree.minNode(), tree.getRoot()); }
 
-  iterator end() { return iterator(nullptr, tree->getRoot()); }
+  iterator end() { return iterator(nullptr, tree.getRoot()); }
 
   const_iterator cbegin() const noexcept {
-    return const_iterator(tree->minNode(), tree->getRoot());
+    return const_iterator(tree.minNode(), tree.getRoot());
   }
 
   const_iterator cend() const noexcept {
-    return const_iterator(nullptr, tree->getRoot());
+    return const_iterator(nullptr, tree.getRoot());
   }
 
   std::pair<iterator, bool> insert(const value_type& value) {
-    return tree->insertUnique(value);
+    std::pair<iterator, bool> result = tree.insertUnique(value);
+    if (result.second) logChange(change::inserted, value);
+    if (result.second && bloom != nullptr) {
+      bloom->insert(value);
+      if (bloom->overloaded()) rebuildBloom(bloom->capacity() * 2);
+    }
+    return result;
   }
 
-  void erase(iterator pos) { tree->erase(pos); }
-  void swap(set& other) { std::swap(tree, other.tree); }
+  void erase(iterator pos) {
+    logChange(change::erased, *pos);
+    tree.erase(pos);
+    if (bloom != nullptr) bloom->noteErase();
+  }
 
-  void clear() { tree->clearTree(); }
+  void swap(set& other) {
+    tree.swap(other.tree);
+    std::swap(bloom, other.bloom);
+    std::swap(undo, other.undo);
+  }
+
+  void clear() {
+    logAll(change::erased);
+    tree.clearTree(backgroundReclaim);
+    if (bloom != nullptr) bloom->clear();
+  }
+
+  // Opt-in: clear() and the destructor hand the elements to a background
+  // thread and return at once. Element destructors then run on that thread.
+  void set_background_reclaim(bool enabled) noexcept {
+    backgroundReclaim = enabled;
+  }
+
+  bool background_reclaim() const noexcept { return backgroundReclaim; }
+
+  // Shape of the underlying tree plus, when built with
+  // S21_CONTAINERS_STATS, its operation counters. Takes O(n).
+  tree_stats stats() const { return tree.stats(); }
+
+  void reset_counters() noexcept { tree.resetCounters(); }
 
   void merge(set& other) {
     auto otherEnd = other.end();
@@ -91,9 +154,153 @@ class set {
     other.clear();
   }
 
-  iterator find(const Key& key) { return tree->find(key); }
+  // Calls fn on each element with a key in [lo, hi), in key order.
+  template <typename Fn>
+  void for_each_in_range(const Key& lo, const Key& hi, Fn fn) {
+    tree.forEachInRange(lo, hi, [&](const value_type& value) { fn(value); });
+  }
+
+  // Moves all elements into one contiguous block in the given layout to
+  // restore memory locality after churn. Invalidates iterators and element
+  // pointers.
+  void compact(node_layout layout = node_layout::in_order) {
+    tree.compact(layout);
+  }
+
+  // Incremental compaction: begin_compact fixes the order and each
+  // compact_step moves at most max_nodes elements, returning true when done.
+  // Elements moved by a step invalidate their iterators and pointers.
+  void begin_compact(node_layout layout = node_layout::in_order) {
+    tree.beginCompaction(layout);
+  }
+
+  bool compact_step(size_type max_nodes) {
+    return tree.compactStep(max_nodes);
+  }
+
+  // Applies a batch of inserts and erases in one sorted merge. A later
+  // update of the same key overrides an earlier one; an insert of a present
+  // key overwrites the element.
+  void apply_batch(std::vector<update_type> updates) {
+    if (undo != nullptr) logBatch(updates);
+    if (bloom != nullptr) {
+      for (const update_type& update : updates) {
+        if (update.op == batch_op::insert) {
+          bloom->insert(update.value);
+        } else {
+          bloom->noteErase();
+        }
+      }
+    }
+    tree.applyBatch(std::move(updates));
+    if (bloom != nullptr && bloom->overloaded()) rebuildBloom(2 * size());
+  }
 
-  bool contains(const Key& key) { return tree->contains(key); }
+  // Removes all elements matching pred in one traversal and returns how
+  // many were removed.
+  template <typename Pred>
+  size_type erase_if(Pred pred) {
+    size_type removed = tree.eraseIf([&](const value_type& value) {
+      if (!pred(value)) return false;
+      logChange(change::erased, value);
+      return true;
+    });
+    if (bloom != nullptr) bloom->noteErase(removed);
+    return removed;
+  }
+
+  // Transactions: from begin_txn() on, every insert and erase is logged, so
+  // a rollback costs O(k log n) for k changes rather than a copy of the
+  // set. savepoint() marks a position that rollback(savepoint) returns to
+  // while the transaction stays open; rollback() undoes everything and
+  // commit() keeps it, both ending the transaction.
+  void begin_txn() {
+    if (undo != nullptr) throw std::logic_error("transaction already open");
+    undo = new undo_log;
+  }
+
+  bool in_txn() const noexcept { return undo != nullptr; }
+
+  size_type savepoint() const { return activeLog()->savepoint(); }
+
+  void rollback(size_type savepoint) {
+    activeLog()->rollbackTo(savepoint, [this](const auto& entry) {
+      undoChange(entry.kind, entry.value);
+    });
+  }
+
+  void rollback() {
+    rollback(0);
+    commit();
+  }
+
+  void commit() {
+    delete activeLog();
+    undo = nullptr;
+  }
+
+  // Lookups never throw: find() returns end() and try_get() returns
+  // nullptr for an absent key.
+  iterator find(const Key& key) {
+    return iterator(findNode(key), tree.getRoot());
+  }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator find(const K& key) {
+    return tree.find(key);
+  }
+
+  bool contains(const Key& key) { return findNode(key) != nullptr; }
+
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K& key) {
+    return tree.contains(key);
+  }
+
+  const value_type* try_get(const Key& key) {
+    Node* node = findNode(key);
+    return node != nullptr ? &node->data : nullptr;
+  }
+
+  value_type get_or(const Key& key, const value_type& fallback) {
+    Node* node = findNode(key);
+    return node != nullptr ? node->data : fallback;
+  }
+
+  key_compare key_comp() const { return tree.keyCompare(); }
+
+  value_compare value_comp() const { return tree.keyCompare(); }
+
+  // Puts a Bloom filter sized for the current contents in front of
+  // find/contains so that most lookups of absent keys skip the tree walk.
+  void enable_bloom_filter(double false_positive_rate = 0.01) {
+    static_assert(IsHashable<Key, std::hash<Key>>::value,
+                  "Bloom filter requires std::hash<Key>");
+    bloom_stats stats = bloom_filter_stats();
+    delete bloom;
+    bloom = nullptr;
+    bloom = new BloomFilter<Key>(size(), false_positive_rate);
+    bloom->setStats(stats);
+    for (auto it = begin(); it != end(); ++it) bloom->insert(*it);
+  }
+
+  void disable_bloom_filter() {
+    delete bloom;
+    bloom = nullptr;
+  }
+
+  bool bloom_filter_enabled() const noexcept { return bloom != nullptr; }
+
+  // Erased keys stay in the filter as false positives until it is rebuilt.
+  void rebuild_bloom_filter() {
+    if (bloom != nullptr) rebuildBloom(size());
+  }
+
+  bloom_stats bloom_filter_stats() const noexcept {
+    return bloom != nullptr ? bloom->stats() : bloom_stats();
+  }
 
   template <typename... Args>
   std::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
@@ -106,7 +313,63 @@ class set {
   }
 
  private:
-  BinaryTree<Key, Key, setCompare>* tree;
+  Node* findNode(const Key& key) {
+    if (bloom != nullptr && !bloom->admit(key)) return nullptr;
+    Node* node = tree.search(key);
+    if (bloom != nullptr) bloom->recordResult(node != nullptr);
+    return node;
+  }
+
+  undo_log* activeLog() const {
+    if (undo == nullptr) throw std::logic_error("no open transaction");
+    return undo;
+  }
+
+  void logChange(change kind, const value_type& value) {
+    if (undo != nullptr) undo->record(kind, value);
+  }
+
+  void logAll(change kind) {
+    if (undo == nullptr) return;
+    for (auto it = begin(); it != end(); ++it) undo->record(kind, *it);
+  }
+
+  // Logs each update against the state before the batch. Repeated keys may
+  // log more than is applied; undoing a change that did not happen is a
+  // no-op.
+  void logBatch(const std::vector<update_type>& updates) {
+    for (const update_type& update : updates) {
+      Node* node = tree.search(update.value);
+      if (node != nullptr && update.op == batch_op::erase) {
+        undo->record(change::erased, node->data);
+      } else if (node == nullptr && update.op == batch_op::insert) {
+        undo->record(change::inserted, update.value);
+      }
+    }
+  }
+
+  void undoChange(change kind, const value_type& value) {
+    Node* node = tree.search(value);
+    if (kind == change::inserted && node != nullptr) {
+      erase(iterator(node, tree.getRoot()));
+    } else if (kind == change::erased && node == nullptr) {
+      insert(value);
+    }
+  }
+
+  void rebuildBloom(size_type capacity) {
+    BloomFilter<Key>* rebuilt =
+        new BloomFilter<Key>(capacity, bloom->fp_rate());
+    rebuilt->setStats(bloom->stats());
+    for (auto it = begin(); it != end(); ++it) rebuilt->insert(*it);
+    delete bloom;
+    bloom = rebuilt;
+  }
+
+  tree_type tree;
+  bool backgroundReclaim = false;
+  BloomFilter<Key>* bloom = nullptr;
+  undo_log* undo = nullptr;
 };
 
 }  // namespace s21
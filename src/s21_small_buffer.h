@@ -0,0 +1,157 @@
+#ifndef S21_CONTAINERS_SMALL_BUFFER_H
+#define S21_CONTAINERS_SMALL_BUFFER_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace s21 {
+// Contiguous sequence that keeps up to N elements inside the object and
+// moves to the heap only when it grows past them. Used where most
+// sequences are short and an allocation per sequence would dominate.
+template <typename T, std::size_t N>
+class SmallBuffer {
+ public:
+  using size_type = std::size_t;
+
+  static_assert(N > 0, "SmallBuffer needs inline capacity");
+
+  SmallBuffer() noexcept : data_(inlineData()) {}
+
+  SmallBuffer(const SmallBuffer &other) : SmallBuffer() {
+    reserve(other.size_);
+    for (size_type i = 0; i < other.size_; ++i) push_back(other[i]);
+  }
+
+  SmallBuffer(SmallBuffer &&other) noexcept : SmallBuffer() {
+    takeFrom(other);
+  }
+
+  SmallBuffer &operator=(const SmallBuffer &other) {
+    if (this != &other) {
+      SmallBuffer copy(other);
+      clear();
+      releaseHeap();
+      takeFrom(copy);
+    }
+    return *this;
+  }
+
+  SmallBuffer &operator=(SmallBuffer &&other) noexcept {
+    if (this != &other) {
+      clear();
+      releaseHeap();
+      takeFrom(other);
+    }
+    return *this;
+  }
+
+  ~SmallBuffer() {
+    clear();
+    releaseHeap();
+  }
+
+  // The arguments may refer to an element of this buffer: when it is full,
+  // the new element is built in the grown storage before the old ones move.
+  template <typename... Args>
+  T &emplace_back(Args &&...args) {
+    T *slot;
+    if (size_ < capacity_) {
+      slot = new (data_ + size_) T(std::forward<Args>(args)...);
+    } else {
+      size_type capacity = 2 * capacity_;
+      T *grown = static_cast<T *>(::operator new(capacity * sizeof(T)));
+      try {
+        slot = new (grown + size_) T(std::forward<Args>(args)...);
+      } catch (...) {
+        ::operator delete(grown);
+        throw;
+      }
+      moveTo(grown, capacity);
+    }
+    ++size_;
+    return *slot;
+  }
+
+  void push_back(const T &value) { emplace_back(value); }
+
+  // Shifts the following elements down, keeping the order.
+  void erase(size_type index) {
+    for (size_type i = index; i + 1 < size_; ++i) {
+      data_[i] = std::move(data_[i + 1]);
+    }
+    data_[--size_].~T();
+  }
+
+  void clear() noexcept {
+    for (size_type i = 0; i < size_; ++i) data_[i].~T();
+    size_ = 0;
+  }
+
+  void reserve(size_type capacity) {
+    if (capacity <= capacity_) return;
+    moveTo(static_cast<T *>(::operator new(capacity * sizeof(T))), capacity);
+  }
+
+  T &operator[](size_type index) noexcept { return data_[index]; }
+  const T &operator[](size_type index) const noexcept { return data_[index]; }
+
+  T *begin() noexcept { return data_; }
+  T *end() noexcept { return data_ + size_; }
+  const T *begin() const noexcept { return data_; }
+  const T *end() const noexcept { return data_ + size_; }
+
+  size_type size() const noexcept { return size_; }
+  size_type capacity() const noexcept { return capacity_; }
+  bool empty() const noexcept { return size_ == 0; }
+  bool inlined() const noexcept { return data_ == inlineData(); }
+
+ private:
+  T *inlineData() noexcept { return reinterpret_cast<T *>(storage_); }
+
+  const T *inlineData() const noexcept {
+    return reinterpret_cast<const T *>(storage_);
+  }
+
+  void releaseHeap() noexcept {
+    if (!inlined()) ::operator delete(data_);
+    data_ = inlineData();
+    capacity_ = N;
+  }
+
+  // Moves the elements into grown, which holds capacity elements, and
+  // makes it the storage.
+  void moveTo(T *grown, size_type capacity) {
+    for (size_type i = 0; i < size_; ++i) {
+      new (grown + i) T(std::move(data_[i]));
+      data_[i].~T();
+    }
+    releaseHeap();
+    data_ = grown;
+    capacity_ = capacity;
+  }
+
+  // Expects this buffer empty and inline; leaves other empty and inline.
+  void takeFrom(SmallBuffer &other) noexcept {
+    if (other.inlined()) {
+      for (size_type i = 0; i < other.size_; ++i) {
+        new (data_ + i) T(std::move(other.data_[i]));
+      }
+      size_ = other.size_;
+      other.clear();
+    } else {
+      data_ = std::exchange(other.data_, other.inlineData());
+      capacity_ = std::exchange(other.capacity_, N);
+      size_ = std::exchange(other.size_, 0);
+    }
+  }
+
+  T *data_;
+  size_type size_ = 0;
+  size_type capacity_ = N;
+  alignas(T) unsigned char storage_[sizeof(T) * N];
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_SMALL_BUFFER_H
@@ -0,0 +1,249 @@
+#ifndef S21_CONTAINERS_SPLIT_MAP_H
+#define S21_CONTAINERS_SPLIT_MAP_H
+
+#include "s21_binary_tree.h"
+#include "s21_value_slab.h"
+
+namespace s21 {
+// Ordered map that keeps only keys and links in the tree nodes; the mapped
+// values live in a slab and nodes refer to them by slot index. Descents
+// touch compact nodes only, which pays off when T is large. Iterators yield
+// std::pair<const Key&, T&> proxies; references to mapped values stay valid
+// until their element is erased.
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Balance = avl_balance>
+class split_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<key_type, mapped_type>;
+  using reference = std::pair<const key_type&, mapped_type&>;
+  using const_reference = std::pair<const key_type&, const mapped_type&>;
+  using size_type = std::size_t;
+  using key_compare = Compare;
+
+  using slab_type = ValueSlab<mapped_type>;
+  using slot_type = std::pair<key_type, typename slab_type::index_type>;
+  using tree_type = BinaryTree<key_type, slot_type, Compare, Balance>;
+  using Node = typename tree_type::Node;
+
+  template <bool isConst>
+  class splitIterator;
+  using iterator = splitIterator<false>;
+  using const_iterator = splitIterator<true>;
+
+  split_map() = default;
+
+  explicit split_map(const Compare& comp) : tree(comp) {}
+
+  split_map(std::initializer_list<value_type> const& items,
+            const Compare& comp = Compare())
+      : tree(comp) {
+    for (auto item : items) {
+      insert(item);
+    }
+  }
+
+  // The copied tree still names the source's slots; each node gets a fresh
+  // slot in this map's slab, in key order. If a value copy throws, the
+  // values copied so far are destroyed before the members unwind.
+  split_map(const split_map& m) : tree(m.tree) {
+    Node* n = tree.minNode();
+    try {
+      for (; n != nullptr; n = n->moveForward()) {
+        n->data.second = values.emplace(m.values[n->data.second]);
+      }
+    } catch (...) {
+      for (Node* done = tree.minNode(); done != n;
+           done = done->moveForward()) {
+        values.destroy(done->data.second);
+      }
+      values.release();
+      throw;
+    }
+  }
+
+  split_map(split_map&& m)
+      : tree(std::move(m.tree)), values(std::move(m.values)) {}
+
+  split_map& operator=(split_map& m) {
+    if (this != &m) {
+      split_map copy(m);
+      swap(copy);
+    }
+    return *this;
+  }
+
+  split_map& operator=(split_map&& m) {
+    if (this != &m) {
+      clear();
+      tree = std::move(m.tree);
+      values = std::move(m.values);
+    }
+    return *this;
+  }
+
+  ~split_map() { destroyValues(); }
+
+  T& at(const Key& key) {
+    Node* node = tree.search(key);
+    if (node == nullptr) throw std::out_of_range("no key found");
+    return values[node->data.second];
+  }
+
+  // Inserts a value-initialized element when the key is absent.
+  T& operator[](const Key& key) { return (*try_emplace(key).first).second; }
+
+  iterator begin() { return iterator(tree.minNode(), this); }
+
+  iterator end() { return iterator(nullptr, this); }
+
+  const_iterator cbegin() const noexcept {
+    return const_iterator(tree.minNode(), this);
+  }
+
+  const_iterator cend() const noexcept { return const_iterator(nullptr, this); }
+
+  bool empty() { return tree.empty(); }
+
+  size_type size() { return tree.size(); }
+
+  size_type max_size() {
+    size_type byMemory = (std::numeric_limits<size_type>::max() / 2) /
+                         (sizeof(Node) + sizeof(T));
+    return std::min(byMemory, slab_type::kMaxSlots);
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return try_emplace(value.first, value.second);
+  }
+
+  std::pair<iterator, bool> insert(const Key& key, const T& obj) {
+    return try_emplace(key, obj);
+  }
+
+  std::pair<iterator, bool> insert_or_assign(const Key& key, const T& obj) {
+    std::pair<iterator, bool> result = try_emplace(key, obj);
+    if (!result.second) (*result.first).second = obj;
+    return result;
+  }
+
+  // The mapped value is constructed in its slot only if the key is absent.
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    auto result = tree.emplaceUnique(key, [&] {
+      return slot_type(key, values.emplace(std::forward<Args>(args)...));
+    });
+    return {iterator(result.first.iter, this), result.second};
+  }
+
+  void erase(iterator pos) {
+    typename slab_type::index_type slot = pos.node->data.second;
+    tree.erase(typename tree_type::iterator(pos.node, tree.getRoot()));
+    values.destroy(slot);
+  }
+
+  void swap(split_map& other) {
+    tree.swap(other.tree);
+    std::swap(values, other.values);
+  }
+
+  void clear() {
+    destroyValues();
+    tree.clearTree();
+  }
+
+  void merge(split_map& other) {
+    auto otherEnd = other.end();
+    for (auto it = other.begin(); it != otherEnd; ++it) {
+      try_emplace((*it).first, (*it).second);
+    }
+    other.clear();
+  }
+
+  bool contains(const Key& key) { return tree.contains(key); }
+
+  iterator find(const Key& key) { return iterator(tree.search(key), this); }
+
+  T* try_get(const Key& key) {
+    Node* node = tree.search(key);
+    return node != nullptr ? &values[node->data.second] : nullptr;
+  }
+
+  T get_or(const Key& key, const T& fallback) {
+    Node* node = tree.search(key);
+    return node != nullptr ? values[node->data.second] : fallback;
+  }
+
+  key_compare key_comp() const { return tree.keyCompare(); }
+
+  template <bool isConst>
+  class splitIterator {
+    using owner_type =
+        typename std::conditional<isConst, const split_map, split_map>::type;
+
+   public:
+    using reference =
+        typename std::conditional<isConst, split_map::const_reference,
+                                  split_map::reference>::type;
+
+    // operator-> needs an object to point at; the proxy pair is built on
+    // demand and lives as long as the returned wrapper.
+    struct pointer {
+      reference ref;
+      const reference* operator->() const noexcept { return &ref; }
+    };
+
+    splitIterator(Node* node_, owner_type* owner_)
+        : node(node_), owner(owner_) {}
+
+    // A non-const iterator converts to a const one.
+    template <bool otherConst,
+              typename = std::enable_if_t<isConst && !otherConst>>
+    splitIterator(const splitIterator<otherConst>& other)
+        : node(other.node), owner(other.owner) {}
+
+    reference operator*() const {
+      return reference(node->data.first, owner->values[node->data.second]);
+    }
+
+    pointer operator->() const { return pointer{**this}; }
+
+    splitIterator& operator++() {
+      node = node->moveForward();
+      return *this;
+    }
+
+    splitIterator& operator--() {
+      node = (node == nullptr) ? owner->tree.getRoot()->getMax()
+                               : node->moveBack();
+      return *this;
+    }
+
+    bool operator==(const splitIterator& other) const noexcept {
+      return node == other.node;
+    }
+
+    bool operator!=(const splitIterator& other) const noexcept {
+      return node != other.node;
+    }
+
+    Node* node;
+    owner_type* owner;
+  };
+
+ private:
+  void destroyValues() {
+    for (Node* n = tree.minNode(); n != nullptr; n = n->moveForward()) {
+      values.destroy(n->data.second);
+    }
+    values.release();
+  }
+
+  tree_type tree;
+  slab_type values;
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_SPLIT_MAP_H
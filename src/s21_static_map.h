@@ -0,0 +1,249 @@
+#ifndef S21_CONTAINERS_STATIC_MAP_H
+#define S21_CONTAINERS_STATIC_MAP_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "s21_array.h"
+
+namespace s21 {
+// Hash of a static_map or static_set key usable in constant expressions:
+// integers and enums hash to their value, string views by FNV-1a over
+// their characters. Specialize with a constexpr operator() for other keys.
+template <typename Key, typename = void>
+struct static_hash {
+  static_assert(std::is_integral<Key>::value || std::is_enum<Key>::value,
+                "specialize s21::static_hash for this key type");
+
+  constexpr std::uint64_t operator()(const Key &key) const noexcept {
+    return static_cast<std::uint64_t>(key);
+  }
+};
+
+template <>
+struct static_hash<std::string_view> {
+  constexpr std::uint64_t operator()(std::string_view key) const noexcept {
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for (char c : key) {
+      h ^= static_cast<unsigned char>(c);
+      h *= 0x100000001b3ULL;
+    }
+    return h;
+  }
+};
+
+// Element of a static_map. Unlike std::pair it can be assigned in a
+// constant expression under C++17.
+template <typename Key, typename T>
+struct static_entry {
+  Key first;
+  T second;
+};
+
+// Common part of static_map and static_set: the elements in declaration
+// order plus a perfect hash over them, all computed by the constructor, so
+// a constexpr table costs nothing at run time. Keys are spread over
+// kBuckets buckets; each bucket stores the seed that sends all of its keys
+// to free slots of a table twice that size, found largest bucket first.
+// A lookup hashes once, reads the bucket seed and compares one key.
+template <typename Key, typename Value, std::size_t N, typename Hash>
+class StaticTable {
+ public:
+  using key_type = Key;
+  using value_type = Value;
+  using const_reference = const value_type &;
+  using const_iterator = const value_type *;
+  using iterator = const_iterator;
+  using size_type = std::size_t;
+  using hasher = Hash;
+
+  static_assert(N > 0, "a static table needs at least one element");
+
+  static constexpr size_type kBuckets = [] {
+    size_type buckets = 1;
+    while (buckets < N) buckets *= 2;
+    return buckets;
+  }();
+  static constexpr size_type kSlots = 2 * kBuckets;
+
+  // Throws std::invalid_argument for a repeated key, which makes a
+  // constexpr table with one fail to compile.
+  constexpr explicit StaticTable(const value_type (&items)[N]) {
+    for (size_type i = 0; i < N; ++i) elements[i] = items[i];
+    build();
+  }
+
+  constexpr const_iterator begin() const { return elements.begin(); }
+
+  constexpr const_iterator end() const { return elements.end(); }
+
+  constexpr const_iterator cbegin() const { return begin(); }
+
+  constexpr const_iterator cend() const { return end(); }
+
+  constexpr bool empty() const noexcept { return false; }
+
+  constexpr size_type size() const noexcept { return N; }
+
+  constexpr size_type max_size() const noexcept { return N; }
+
+  constexpr const_iterator find(const Key &key) const {
+    std::uint64_t h = Hash()(key);
+    size_type index = slots[slotOf(h, seeds[bucketOf(h)])];
+    if (index < N && keyOf(elements[index]) == key) return begin() + index;
+    return end();
+  }
+
+  constexpr bool contains(const Key &key) const { return find(key) != end(); }
+
+  constexpr size_type count(const Key &key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+ protected:
+  static constexpr std::uint64_t kMaxSeed = std::uint64_t(1) << 16;
+
+  static constexpr const Key &keyOf(const value_type &value) noexcept {
+    if constexpr (std::is_same<Key, Value>::value) {
+      return value;
+    } else {
+      return value.first;
+    }
+  }
+
+  static constexpr std::uint64_t mix(std::uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  static constexpr size_type bucketOf(std::uint64_t h) noexcept {
+    return size_type(mix(h) & (kBuckets - 1));
+  }
+
+  static constexpr size_type slotOf(std::uint64_t h,
+                                    std::uint32_t seed) noexcept {
+    return size_type(mix(h + (seed + 1) * 0x9e3779b97f4a7c15ULL) &
+                     (kSlots - 1));
+  }
+
+  // Groups the elements by bucket with a counting sort, then places the
+  // buckets from the largest down while free slots are plentiful.
+  constexpr void build() {
+    for (size_type s = 0; s < kSlots; ++s) slots[s] = N;
+    std::uint64_t hashes[N] = {};
+    size_type start[kBuckets + 1] = {};
+    size_type largest = 0;
+    for (size_type i = 0; i < N; ++i) {
+      hashes[i] = Hash()(keyOf(elements[i]));
+      size_type count = ++start[bucketOf(hashes[i]) + 1];
+      if (count > largest) largest = count;
+    }
+    for (size_type b = 0; b < kBuckets; ++b) start[b + 1] += start[b];
+    size_type members[N] = {};
+    size_type filled[kBuckets] = {};
+    for (size_type i = 0; i < N; ++i) {
+      size_type b = bucketOf(hashes[i]);
+      members[start[b] + filled[b]++] = i;
+    }
+    for (size_type size = largest; size > 0; --size) {
+      for (size_type b = 0; b < kBuckets; ++b) {
+        if (start[b + 1] - start[b] == size) {
+          place(b, members + start[b], size, hashes);
+        }
+      }
+    }
+  }
+
+  constexpr void place(size_type bucket, const size_type *members,
+                       size_type count, const std::uint64_t *hashes) {
+    for (size_type k = 0; k < count; ++k) {
+      for (size_type j = 0; j < k; ++j) {
+        if (keyOf(elements[members[j]]) == keyOf(elements[members[k]])) {
+          throw std::invalid_argument("duplicate key in static table");
+        }
+      }
+    }
+    for (std::uint32_t seed = 0; seed < kMaxSeed; ++seed) {
+      size_type taken[N] = {};
+      bool fits = true;
+      for (size_type k = 0; k < count && fits; ++k) {
+        taken[k] = slotOf(hashes[members[k]], seed);
+        fits = slots[taken[k]] == N;
+        for (size_type j = 0; j < k && fits; ++j) fits = taken[j] != taken[k];
+      }
+      if (fits) {
+        seeds[bucket] = seed;
+        for (size_type k = 0; k < count; ++k) slots[taken[k]] = members[k];
+        return;
+      }
+    }
+    throw std::logic_error("no perfect hash found for static table");
+  }
+
+  array<value_type, N> elements;
+  array<std::uint32_t, kBuckets> seeds;
+  array<size_type, kSlots> slots;
+};
+
+// Read-only map fixed at compile time, e.g. protocol tables:
+//   constexpr s21::static_map<std::string_view, int, 2> codes{
+//       {{"get", 1}, {"put", 2}}};
+// Lookups are one hash, one probe and one key comparison, allocate
+// nothing and work in constant expressions. Iteration follows the order
+// of the initializer.
+template <typename Key, typename T, std::size_t N,
+          typename Hash = static_hash<Key>>
+class static_map : public StaticTable<Key, static_entry<Key, T>, N, Hash> {
+  using base = StaticTable<Key, static_entry<Key, T>, N, Hash>;
+
+ public:
+  using mapped_type = T;
+  using typename base::value_type;
+
+  using base::base;
+
+  constexpr const T &at(const Key &key) const {
+    typename base::const_iterator it = this->find(key);
+    if (it == this->end()) throw std::out_of_range("no key found");
+    return it->second;
+  }
+
+  // Returns a copy of the element, or fallback for an absent key.
+  constexpr T get_or(const Key &key, const T &fallback) const {
+    typename base::const_iterator it = this->find(key);
+    return it != this->end() ? it->second : fallback;
+  }
+};
+
+// Read-only set fixed at compile time; see static_map.
+template <typename Key, std::size_t N, typename Hash = static_hash<Key>>
+class static_set : public StaticTable<Key, Key, N, Hash> {
+  using base = StaticTable<Key, Key, N, Hash>;
+
+ public:
+  using base::base;
+};
+
+// Deduce the size from the initializer:
+//   constexpr auto codes =
+//       s21::make_static_map<std::string_view, int>({{"get", 1}});
+template <typename Key, typename T, typename Hash = static_hash<Key>,
+          std::size_t N>
+constexpr static_map<Key, T, N, Hash> make_static_map(
+    const static_entry<Key, T> (&items)[N]) {
+  return static_map<Key, T, N, Hash>(items);
+}
+
+template <typename Key, typename Hash = static_hash<Key>, std::size_t N>
+constexpr static_set<Key, N, Hash> make_static_set(const Key (&items)[N]) {
+  return static_set<Key, N, Hash>(items);
+}
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_STATIC_MAP_H
@@ -0,0 +1,450 @@
+#ifndef S21_CONTAINERS_TREE_BALANCE_H
+#define S21_CONTAINERS_TREE_BALANCE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace s21 {
+// Balancing policies for BinaryTree. A policy provides the per-node fields
+// it needs (node_fields, stored in every node as `fields`), update() to
+// recompute those fields from the children after a rotation, and the fix-ups
+// run after a node has been linked in (afterInsert) or spliced out
+// (afterErase). The fix-ups restructure the tree only through
+// tree.rotateLeft/rotateRight and report each node they visit through
+// tree.noteRebalanceStep. Bulk construction builds a perfectly balanced
+// tree bottom-up and calls afterBuild on each node once its children are in
+// place; depth counts from the root and maxDepth is the deepest level.
+
+// Strict height balance: subtree heights differ by at most one. Shortest
+// search paths, more rotations on updates.
+struct avl_balance {
+  struct node_fields {
+    int height = 1;
+  };
+
+  template <typename Node>
+  static int height(const Node *node) noexcept {
+    return node != nullptr ? node->fields.height : 0;
+  }
+
+  template <typename Node>
+  static void update(Node *node) noexcept {
+    node->fields.height =
+        1 + std::max(height(node->left), height(node->right));
+  }
+
+  template <typename Node>
+  static void afterBuild(Node *node, int, int) noexcept {
+    update(node);
+  }
+
+  template <typename Tree, typename Node>
+  static void afterInsert(Tree &tree, Node *node) {
+    rebalancePath(tree, node->parent);
+  }
+
+  template <typename Tree, typename Node>
+  static void afterErase(Tree &tree, Node *parent, Node *,
+                         const node_fields &) {
+    rebalancePath(tree, parent);
+  }
+
+  template <typename Tree, typename Node>
+  static void rebalancePath(Tree &tree, Node *node) {
+    while (node != nullptr) {
+      tree.noteRebalanceStep();
+      Node *parent = node->parent;
+      update(node);
+      int factor = height(node->right) - height(node->left);
+      if (factor > 1) {
+        if (height(node->right->left) > height(node->right->right)) {
+          tree.rotateRight(node->right);
+        }
+        tree.rotateLeft(node);
+      } else if (factor < -1) {
+        if (height(node->left->right) > height(node->left->left)) {
+          tree.rotateLeft(node->left);
+        }
+        tree.rotateRight(node);
+      }
+      node = parent;
+    }
+  }
+};
+
+// Red-black colouring: at most two rotations per insert and three per erase,
+// at the price of paths up to twice the minimum length.
+struct red_black_balance {
+  struct node_fields {
+    bool red = true;
+  };
+
+  template <typename Node>
+  static bool isRed(const Node *node) noexcept {
+    return node != nullptr && node->fields.red;
+  }
+
+  template <typename Node>
+  static void update(Node *) noexcept {}
+
+  // Only the deepest level of a perfectly balanced tree is red, which keeps
+  // every root-to-leaf path at the same black height.
+  template <typename Node>
+  static void afterBuild(Node *node, int depth, int maxDepth) noexcept {
+    node->fields.red = depth > 0 && depth == maxDepth;
+  }
+
+  template <typename Tree, typename Node>
+  static void afterInsert(Tree &tree, Node *node) {
+    while (isRed(node->parent)) {
+      tree.noteRebalanceStep();
+      Node *parent = node->parent;
+      Node *grand = parent->parent;
+      bool parentIsLeft = grand->left == parent;
+      Node *uncle = parentIsLeft ? grand->right : grand->left;
+      if (isRed(uncle)) {
+        parent->fields.red = false;
+        uncle->fields.red = false;
+        grand->fields.red = true;
+        node = grand;
+        continue;
+      }
+      if (parentIsLeft && node == parent->right) {
+        tree.rotateLeft(parent);
+        node = parent;
+        parent = node->parent;
+      } else if (!parentIsLeft && node == parent->left) {
+        tree.rotateRight(parent);
+        node = parent;
+        parent = node->parent;
+      }
+      parent->fields.red = false;
+      grand->fields.red = true;
+      parentIsLeft ? tree.rotateRight(grand) : tree.rotateLeft(grand);
+    }
+    tree.getRoot()->fields.red = false;
+  }
+
+  // `node` took the place of a spliced-out node whose colour was `removed`;
+  // it may be null, so its parent is passed separately.
+  template <typename Tree, typename Node>
+  static void afterErase(Tree &tree, Node *parent, Node *node,
+                         const node_fields &removed) {
+    if (removed.red) return;
+    while (node != tree.getRoot() && !isRed(node)) {
+      tree.noteRebalanceStep();
+      bool isLeft = parent->left == node;
+      Node *sibling = isLeft ? parent->right : parent->left;
+      if (isRed(sibling)) {
+        sibling->fields.red = false;
+        parent->fields.red = true;
+        isLeft ? tree.rotateLeft(parent) : tree.rotateRight(parent);
+        sibling = isLeft ? parent->right : parent->left;
+      }
+      Node *near = isLeft ? sibling->left : sibling->right;
+      Node *far = isLeft ? sibling->right : sibling->left;
+      if (!isRed(near) && !isRed(far)) {
+        sibling->fields.red = true;
+        node = parent;
+        parent = node->parent;
+        continue;
+      }
+      if (!isRed(far)) {
+        near->fields.red = false;
+        sibling->fields.red = true;
+        isLeft ? tree.rotateRight(sibling) : tree.rotateLeft(sibling);
+        sibling = isLeft ? parent->right : parent->left;
+        far = isLeft ? sibling->right : sibling->left;
+      }
+      sibling->fields.red = parent->fields.red;
+      parent->fields.red = false;
+      far->fields.red = false;
+      isLeft ? tree.rotateLeft(parent) : tree.rotateRight(parent);
+      node = tree.getRoot();
+    }
+    if (node != nullptr) node->fields.red = false;
+  }
+};
+
+// Weight balance (BB[alpha] with the (3, 2) parameters): a subtree is never
+// more than three times as heavy as its sibling. Subtree sizes are kept in
+// every node, so rebalancing is cheap and sizes are available for free.
+struct weight_balance {
+  struct node_fields {
+    std::size_t weight = 1;
+  };
+
+  static constexpr std::size_t kDelta = 3;
+  static constexpr std::size_t kRatio = 2;
+
+  template <typename Node>
+  static std::size_t weight(const Node *node) noexcept {
+    return node != nullptr ? node->fields.weight : 0;
+  }
+
+  template <typename Node>
+  static void update(Node *node) noexcept {
+    node->fields.weight = 1 + weight(node->left) + weight(node->right);
+  }
+
+  template <typename Node>
+  static void afterBuild(Node *node, int, int) noexcept {
+    update(node);
+  }
+
+  template <typename Tree, typename Node>
+  static void afterInsert(Tree &tree, Node *node) {
+    rebalancePath(tree, node->parent);
+  }
+
+  template <typename Tree, typename Node>
+  static void afterErase(Tree &tree, Node *parent, Node *,
+                         const node_fields &) {
+    rebalancePath(tree, parent);
+  }
+
+  template <typename Tree, typename Node>
+  static void rebalancePath(Tree &tree, Node *node) {
+    while (node != nullptr) {
+      tree.noteRebalanceStep();
+      Node *parent = node->parent;
+      update(node);
+      std::size_t left = weight(node->left) + 1;
+      std::size_t right = weight(node->right) + 1;
+      if (right > kDelta * left) {
+        Node *heavy = node->right;
+        if (weight(heavy->left) + 1 >= kRatio * (weight(heavy->right) + 1)) {
+          tree.rotateRight(heavy);
+        }
+        tree.rotateLeft(node);
+      } else if (left > kDelta * right) {
+        Node *heavy = node->left;
+        if (weight(heavy->right) + 1 >= kRatio * (weight(heavy->left) + 1)) {
+          tree.rotateLeft(heavy);
+        }
+        tree.rotateRight(node);
+      }
+      node = parent;
+    }
+  }
+};
+
+// Wraps a balancing policy and additionally threads every node to its
+// in-order predecessor and successor, so iterator steps take O(1) in the
+// worst case at the cost of two pointers per node. Rotations leave the
+// in-order sequence alone; the tree relinks threads on insert and erase.
+template <typename Balance>
+struct threaded : Balance {
+  static constexpr bool is_threaded = true;
+};
+
+template <typename Augment, typename = void>
+struct UsesKeyCompare : std::false_type {};
+
+template <typename Augment>
+struct UsesKeyCompare<Augment, std::enable_if_t<Augment::uses_key_compare>>
+    : std::true_type {};
+
+// Wraps a balancing policy and caches a summary of every subtree in its
+// root node. Augment::of(value) summarizes one element and
+// Augment::combine(a, b) joins the summaries of two adjacent key ranges, so
+// it must be associative. An Augment that sets uses_key_compare gets the
+// tree's comparator as combine(comp, a, b) instead. Rotations recompute
+// the two nodes they move, and each insert and erase ends with a walk from
+// the changed position to the root, so all summaries are current once an
+// update returns. The tree passes itself to update and afterBuild, unlike
+// for the plain policies.
+template <typename Balance, typename Augment>
+struct augmented : Balance {
+  using augment_type = Augment;
+  using summary_type = typename Augment::summary_type;
+
+  struct node_fields : Balance::node_fields {
+    summary_type summary{};
+  };
+
+  template <typename Tree, typename Node>
+  static void update(const Tree &tree, Node *node) {
+    Balance::update(node);
+    summarize(tree, node);
+  }
+
+  template <typename Tree, typename Node>
+  static void afterBuild(const Tree &tree, Node *node, int depth,
+                         int maxDepth) {
+    Balance::afterBuild(node, depth, maxDepth);
+    summarize(tree, node);
+  }
+
+  template <typename Tree, typename Node>
+  static void afterInsert(Tree &tree, Node *node) {
+    Balance::afterInsert(tree, node);
+    refreshPath(tree, node);
+  }
+
+  template <typename Tree, typename Node>
+  static void afterErase(Tree &tree, Node *parent, Node *node,
+                         const node_fields &removed) {
+    Balance::afterErase(tree, parent, node, removed);
+    refreshPath(tree, parent);
+  }
+
+  template <typename Tree, typename Node>
+  static void refreshPath(const Tree &tree, Node *node) {
+    for (; node != nullptr; node = node->parent) update(tree, node);
+  }
+
+  template <typename Tree>
+  static summary_type join(const Tree &tree, const summary_type &a,
+                           const summary_type &b) {
+    if constexpr (UsesKeyCompare<Augment>::value) {
+      return Augment::combine(tree.keyCompare(), a, b);
+    } else {
+      (void)tree;
+      return Augment::combine(a, b);
+    }
+  }
+
+  template <typename Tree, typename Node>
+  static void summarize(const Tree &tree, Node *node) {
+    summary_type summary = Augment::of(node->data);
+    if (node->left != nullptr) {
+      summary = join(tree, node->left->fields.summary, summary);
+    }
+    if (node->right != nullptr) {
+      summary = join(tree, summary, node->right->fields.summary);
+    }
+    node->fields.summary = std::move(summary);
+  }
+};
+
+template <typename Balance, typename = void>
+struct IsAugmented : std::false_type {};
+
+template <typename Balance>
+struct IsAugmented<Balance, std::void_t<typename Balance::augment_type>>
+    : std::true_type {};
+
+// Monoids over arithmetic values for aggregated maps: an identity element
+// and an associative combine.
+template <typename T>
+struct sum_monoid {
+  using value_type = T;
+  static T identity() { return T(); }
+  static T combine(const T &a, const T &b) { return a + b; }
+};
+
+template <typename T>
+struct min_monoid {
+  using value_type = T;
+  static T identity() { return std::numeric_limits<T>::max(); }
+  static T combine(const T &a, const T &b) { return std::min(a, b); }
+};
+
+template <typename T>
+struct max_monoid {
+  using value_type = T;
+  static T identity() { return std::numeric_limits<T>::lowest(); }
+  static T combine(const T &a, const T &b) { return std::max(a, b); }
+};
+
+// Augmentation that summarizes the mapped values of key-value pairs under
+// a monoid.
+template <typename Monoid>
+struct MappedSummary : Monoid {
+  using summary_type = typename Monoid::value_type;
+
+  template <typename Value>
+  static summary_type of(const Value &value) {
+    return summary_type(value.second);
+  }
+};
+
+// Balance policy for a map whose range aggregates over mapped values are
+// answered in O(log n), e.g. map<Time, long, std::less<Time>,
+// aggregated<sum_monoid<long>>>.
+template <typename Monoid, typename Balance = avl_balance>
+using aggregated = augmented<Balance, MappedSummary<Monoid>>;
+
+// Digest of an element sequence: a polynomial hash over the mixed element
+// hashes, kept together with base^length so that the digests of adjacent
+// ranges can be joined. It depends only on the elements and their order, so
+// two trees with the same contents have equal digests whatever their shape.
+struct merkle_digest {
+  std::uint64_t hash = 0;
+  std::uint64_t power = 1;
+
+  bool operator==(const merkle_digest &other) const noexcept {
+    return hash == other.hash && power == other.power;
+  }
+
+  bool operator!=(const merkle_digest &other) const noexcept {
+    return !(*this == other);
+  }
+};
+
+// Augmentation that keeps the merkle_digest of every subtree. Elements are
+// hashed with std::hash, both halves for key-value pairs.
+struct MerkleHash {
+  using summary_type = merkle_digest;
+
+  static constexpr std::uint64_t kBase = 0x9e3779b97f4a7c15ULL;
+
+  static merkle_digest identity() noexcept { return merkle_digest(); }
+
+  static merkle_digest combine(const merkle_digest &a,
+                               const merkle_digest &b) noexcept {
+    return {a.hash * b.power + b.hash, a.power * b.power};
+  }
+
+  template <typename Value>
+  static merkle_digest of(const Value &value) {
+    return {elementHash(value), kBase};
+  }
+
+  // splitmix64 finalizer: spreads weak std::hash values over all 64 bits.
+  static std::uint64_t mix(std::uint64_t x) noexcept {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  template <typename A, typename B>
+  static std::uint64_t elementHash(const std::pair<A, B> &value) {
+    return mix(mix(std::hash<A>()(value.first)) +
+               std::hash<B>()(value.second));
+  }
+
+  template <typename Value>
+  static std::uint64_t elementHash(const Value &value) {
+    return mix(std::hash<Value>()(value));
+  }
+};
+
+// Balance policy for maps that support O(1) content comparison and a diff
+// whose cost follows the number of differing keys.
+template <typename Balance = avl_balance>
+using merkle = augmented<Balance, MerkleHash>;
+
+template <typename Balance, typename = void>
+struct IsMerkle : std::false_type {};
+
+template <typename Balance>
+struct IsMerkle<Balance, std::void_t<typename Balance::augment_type>>
+    : std::is_same<typename Balance::augment_type, MerkleHash> {};
+
+template <typename Balance, typename = void>
+struct IsThreaded : std::false_type {};
+
+template <typename Balance>
+struct IsThreaded<Balance, std::void_t<decltype(Balance::is_threaded)>>
+    : std::integral_constant<bool, Balance::is_threaded> {};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_TREE_BALANCE_H
@@ -0,0 +1,61 @@
+#ifndef S21_CONTAINERS_UNDO_LOG_H
+#define S21_CONTAINERS_UNDO_LOG_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace s21 {
+// Changes made to a container during a transaction, oldest first, each
+// with the element needed to reverse it: the inserted element, the erased
+// element, or the value an element had before it was overwritten. A
+// savepoint is a position in the log; rolling back past it invalidates it.
+template <typename Value>
+class UndoLog {
+ public:
+  using size_type = std::size_t;
+
+  enum class change { inserted, erased, assigned };
+
+  struct Entry {
+    change kind;
+    Value value;
+  };
+
+  // Changes made while the log is being rolled back are not recorded.
+  void record(change kind, const Value &value) {
+    if (!replaying) entries.push_back(Entry{kind, value});
+  }
+
+  size_type savepoint() const noexcept { return entries.size(); }
+
+  // Passes every entry recorded after position to undo, newest first, and
+  // drops it from the log.
+  template <typename Undo>
+  void rollbackTo(size_type position, Undo undo) {
+    if (position > entries.size()) {
+      throw std::out_of_range("savepoint is no longer valid");
+    }
+    replaying = true;
+    try {
+      while (entries.size() > position) {
+        undo(entries.back());
+        entries.pop_back();
+      }
+    } catch (...) {
+      replaying = false;
+      throw;
+    }
+    replaying = false;
+  }
+
+  size_type size() const noexcept { return entries.size(); }
+
+ private:
+  std::vector<Entry> entries;
+  bool replaying = false;
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_UNDO_LOG_H
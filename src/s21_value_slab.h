@@ -0,0 +1,102 @@
+#ifndef S21_CONTAINERS_VALUE_SLAB_H
+#define S21_CONTAINERS_VALUE_SLAB_H
+
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+// Slot storage for values kept outside the tree nodes. Values live in
+// fixed-size chunks that never move, so a slot's address is stable until it
+// is destroyed; freed slots are reused before new ones are taken. The owner
+// tracks which slots are live.
+template <typename T>
+class ValueSlab {
+ public:
+  using size_type = std::size_t;
+  using index_type = std::uint32_t;
+
+  static constexpr size_type kChunkSize = 64;
+
+  ValueSlab() = default;
+  ValueSlab(const ValueSlab &) = delete;
+  ValueSlab &operator=(const ValueSlab &) = delete;
+
+  ValueSlab(ValueSlab &&other) noexcept
+      : chunks_(std::move(other.chunks_)),
+        free_(std::move(other.free_)),
+        used_(std::exchange(other.used_, 0)) {}
+
+  ValueSlab &operator=(ValueSlab &&other) noexcept {
+    if (this != &other) {
+      release();
+      chunks_ = std::move(other.chunks_);
+      free_ = std::move(other.free_);
+      used_ = std::exchange(other.used_, 0);
+    }
+    return *this;
+  }
+
+  // Live values must have been destroyed by the owner.
+  ~ValueSlab() { release(); }
+
+  template <typename... Args>
+  index_type emplace(Args &&...args) {
+    index_type slot;
+    if (!free_.empty()) {
+      slot = free_.back();
+      new (address(slot)) T(std::forward<Args>(args)...);
+      free_.pop_back();
+      return slot;
+    }
+    if (used_ == kMaxSlots) throw std::length_error("value slab is full");
+    slot = index_type(used_);
+    if (used_ == chunks_.size() * kChunkSize) chunks_.push_back(new Chunk);
+    new (address(slot)) T(std::forward<Args>(args)...);
+    ++used_;
+    return slot;
+  }
+
+  void destroy(index_type slot) {
+    (*this)[slot].~T();
+    free_.push_back(slot);
+  }
+
+  T &operator[](index_type slot) noexcept {
+    return *std::launder(reinterpret_cast<T *>(address(slot)));
+  }
+
+  const T &operator[](index_type slot) const noexcept {
+    return *std::launder(reinterpret_cast<const T *>(
+        const_cast<ValueSlab *>(this)->address(slot)));
+  }
+
+  // Frees the chunks; live values must have been destroyed by the owner.
+  void release() noexcept {
+    for (Chunk *chunk : chunks_) delete chunk;
+    chunks_.clear();
+    free_.clear();
+    used_ = 0;
+  }
+
+  static constexpr size_type kMaxSlots = index_type(-1);
+
+ private:
+  struct Chunk {
+    alignas(T) unsigned char bytes[sizeof(T) * kChunkSize];
+  };
+
+  unsigned char *address(index_type slot) noexcept {
+    return chunks_[slot / kChunkSize]->bytes + sizeof(T) * (slot % kChunkSize);
+  }
+
+  std::vector<Chunk *> chunks_;
+  std::vector<index_type> free_;
+  size_type used_ = 0;
+};
+
+}  // namespace s21
+
+#endif  // S21_CONTAINERS_VALUE_SLAB_H
@@ -51,11 +51,7 @@ class vector {
     }
   }
 
-  ~vector() {
-    if (arr_ != nullptr && size_ > 0) {
-      delete[] arr_;
-    }
-  }
+  ~vector() { delete[] arr_; }
 
   vector<value_type> &operator=(const vector<value_type> &v) {
     if (this != &v) {
@@ -232,14 +228,15 @@ class vector {
   void makeClean_() {
     if (arr_ != nullptr) {
       delete[] arr_;
+      arr_ = nullptr;
       size_ = 0;
       capacity_ = 0;
     }
   }
 
-  value_type *arr_;
-  size_type size_;
-  size_type capacity_;
+  value_type *arr_ = nullptr;
+  size_type size_ = 0;
+  size_type capacity_ = 0;
 };
 }  // namespace s21
 
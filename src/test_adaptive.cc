@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "s21_adaptive.h"
+
+template <typename Set>
+static std::vector<int> keysOf(Set &s) {
+  std::vector<int> keys;
+  for (auto it = s.begin(); it != s.end(); ++it) keys.push_back(*it);
+  return keys;
+}
+
+TEST(adaptive_set_capacity, empty_00) {
+  s21::adaptive_set<int> s1;
+  EXPECT_TRUE(s1.empty());
+  EXPECT_EQ(s1.size(), 0U);
+  EXPECT_TRUE(s1.begin() == s1.end());
+  EXPECT_FALSE(s1.contains(1));
+  EXPECT_EQ(s1.layout(), s21::adaptive_layout::inline_array);
+}
+
+TEST(adaptive_set_mod, insert_00) {
+  s21::adaptive_set<int> s1{5, 1, 4, 1, 3};
+  EXPECT_EQ(s1.size(), 4U);
+  EXPECT_FALSE(s1.insert(4).second);
+  EXPECT_EQ(keysOf(s1), (std::vector<int>{1, 3, 4, 5}));
+  EXPECT_EQ(s1.layout(), s21::adaptive_layout::inline_array);
+}
+
+TEST(adaptive_set_layout, grow_00) {
+  s21::adaptive_set<int, std::less<int>, s21::avl_balance, 4> s1;
+  s1.set_thresholds({8, 1000, 4});
+  for (int i = 0; i < 4; ++i) s1.insert(i);
+  EXPECT_EQ(s1.layout(), s21::adaptive_layout::inline_array);
+  s1.insert(4);
+  EXPECT_EQ(s1.layout(), s21::adaptive_layout::sorted_vector);
+  for (int i = 5; i < 8; ++i) s1.insert(i);
+  EXPECT_EQ(s1.layout(), s21::adaptive_layout::sorted_vector);
+  s1.insert(8);
+  EXPECT_EQ(s1.layout(), s21::adaptive_layout::tree);
+  EXPECT_EQ(keysOf(s1), (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8}));
+}
+
+TEST(adaptive_set_layout, write_heavy_00) {
+  s21::adaptive_set<int, std::less<int>, s21::avl_balance, 4> s1;
+  s1.set_thresholds({1024, 16, 4});
+  for (int i = 0; i < 15; ++i) s1.insert(i);
+  EXPECT_EQ(s1.layout(), s21::adaptive_layout::sorted_vector);
+  // Lookups keep a read-mostly vector from turning into a tree.
+  for (int i = 0; i < 100; ++i) EXPECT_TRUE(s1.contains(i % 15));
+  for (int i = 15; i < 40; ++i) s1.insert(i);
+  EXPECT_EQ(s1.layout(), s21::adaptive_layout::sorted_vector);
+  for (int i = 40; i < 200; ++i) s1.insert(i);
+  EXPECT_EQ(s1.layout(), s21::adaptive_layout::tree);
+  EXPECT_EQ(s1.size(), 200U);
+}
+
+TEST(adaptive_set_layout, shrink_00) {
+  s21::adaptive_set<int, std::less<int>, s21::avl_balance, 4> s1;
+  s1.set_thresholds({16, 1000, 2});
+  for (int i = 0; i < 32; ++i) s1.insert(i);
+  EXPECT_EQ(s1.layout(), s21::adaptive_layout::tree);
+  // A tree that is still written more than read keeps its layout.
+  s1.erase(s1.find(0));
+  EXPECT_EQ(s1.layout(), s21::adaptive_layout::tree);
+  for (int i = 0; i < 64; ++i) s1.contains(i);
+  for (int i = 1; i < 24; ++i) s1.erase(s1.find(i));
+  EXPECT_EQ(s1.layout(), s21::adaptive_layout::sorted_vector);
+  for (int i = 24; i < 30; ++i) s1.erase(s1.find(i));
+  EXPECT_EQ(s1.layout(), s21::adaptive_layout::inline_array);
+  EXPECT_EQ(keysOf(s1), (std::vector<int>{30, 31}));
+  s1.clear();
+  EXPECT_TRUE(s1.empty());
+}
+
+TEST(adaptive_set_mod, copy_move_00) {
+  s21::adaptive_set<int> s1;
+  for (int i = 0; i < 3000; ++i) s1.insert(i * 7 % 3001);
+  EXPECT_EQ(s1.layout(), s21::adaptive_layout::tree);
+  s21::adaptive_set<int> s2(s1);
+  EXPECT_EQ(s2.size(), 3000U);
+  EXPECT_TRUE(s2.contains(7));
+  s21::adaptive_set<int> s3(std::move(s1));
+  EXPECT_TRUE(s1.empty());
+  EXPECT_EQ(s3.size(), 3000U);
+  s21::adaptive_set<int> s4{1, 2};
+  s4 = s3;
+  EXPECT_EQ(s4.size(), 3000U);
+  s4 = s21::adaptive_set<int>{-1};
+  EXPECT_EQ(s4.size(), 1U);
+  s4.merge(s3);
+  EXPECT_EQ(s4.size(), 3001U);
+  EXPECT_TRUE(s3.empty());
+}
+
+TEST(adaptive_set_mod, random_00) {
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> keys(0, 400);
+  s21::adaptive_set<int, std::less<int>, s21::avl_balance, 8> s1;
+  s1.set_thresholds({64, 16, 4});
+  std::set<int> expected;
+  for (int round = 0; round < 20000; ++round) {
+    int key = keys(gen);
+    switch (gen() % 3) {
+      case 0:
+        EXPECT_EQ(s1.insert(key).second, expected.insert(key).second);
+        break;
+      case 1: {
+        auto it = s1.find(key);
+        EXPECT_EQ(it != s1.end(), expected.erase(key) == 1);
+        if (it != s1.end()) s1.erase(it);
+        break;
+      }
+      default:
+        EXPECT_EQ(s1.contains(key), expected.count(key) == 1);
+    }
+    ASSERT_EQ(s1.size(), expected.size());
+  }
+  EXPECT_EQ(keysOf(s1), std::vector<int>(expected.begin(), expected.end()));
+}
+
+TEST(adaptive_map_element, at_00) {
+  s21::adaptive_map<std::string, int> m1{{"b", 2}, {"a", 1}};
+  EXPECT_EQ(m1.at("a"), 1);
+  EXPECT_THROW(m1.at("c"), std::out_of_range);
+  m1["c"] = 3;
+  EXPECT_EQ(m1.at("c"), 3);
+  EXPECT_FALSE(m1.insert("c", 4).second);
+  EXPECT_FALSE(m1.insert_or_assign("c", 4).second);
+  EXPECT_EQ(m1["c"], 4);
+}
+
+TEST(adaptive_map_mod, random_00) {
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<int> keys(0, 2000);
+  s21::adaptive_map<int, std::string> m1;
+  std::map<int, std::string> expected;
+  for (int round = 0; round < 20000; ++round) {
+    int key = keys(gen);
+    if (gen() % 4 == 0) {
+      auto it = m1.find(key);
+      if (it != m1.end()) m1.erase(it);
+      expected.erase(key);
+    } else {
+      m1[key] = std::to_string(round);
+      expected[key] = std::to_string(round);
+    }
+  }
+  ASSERT_EQ(m1.size(), expected.size());
+  auto it = m1.begin();
+  for (const auto &item : expected) {
+    EXPECT_EQ(it->first, item.first);
+    EXPECT_EQ(it->second, item.second);
+    ++it;
+  }
+  EXPECT_TRUE(it == m1.end());
+  --it;
+  EXPECT_EQ(it->first, expected.rbegin()->first);
+}
+
+TEST(adaptive_map_mod, members_00) {
+  // One pass per layout: inline array, sorted vector and tree.
+  const s21::adaptive_layout layouts[] = {
+      s21::adaptive_layout::inline_array, s21::adaptive_layout::sorted_vector,
+      s21::adaptive_layout::tree};
+  const int counts[] = {6, 200, 3000};
+  for (int pass = 0; pass < 3; ++pass) {
+    int count = counts[pass];
+    s21::adaptive_map<int, int> m1;
+    m1.set_thresholds({1024, 100000, 4});
+    std::map<int, int> expected;
+    for (int i = 0; i < count; ++i) {
+      EXPECT_TRUE(m1.try_emplace(i, i).second);
+      expected[i] = i;
+    }
+    EXPECT_EQ(m1.layout(), layouts[pass]);
+    EXPECT_FALSE(m1.try_emplace(0, -1).second);
+    m1.upsert(1, [](int &value) { value += 10; });
+    m1.upsert(count, [](int &value) { value = 7; });
+    expected[1] += 10;
+    expected[count] = 7;
+    auto twice = [](int, const int *current) {
+      return current != nullptr ? *current * 2 : -5;
+    };
+    m1.compute(2, twice);
+    m1.compute(count + 1, twice);
+    expected[2] *= 2;
+    expected[count + 1] = -5;
+    EXPECT_EQ(*m1.try_get(1), 11);
+    EXPECT_EQ(m1.try_get(-1), nullptr);
+    EXPECT_EQ(m1.get_or(-1, 42), 42);
+    m1.apply_batch({{s21::batch_op::insert, {3, 300}},
+                    {s21::batch_op::erase, {4, 0}},
+                    {s21::batch_op::insert, {-2, 2}},
+                    {s21::batch_op::insert, {-2, 3}}});
+    expected[3] = 300;
+    expected.erase(4);
+    expected[-2] = 3;
+    auto odd = [](const std::pair<int, int> &item) {
+      return item.first % 2 != 0;
+    };
+    size_t removed = 0;
+    for (auto it = expected.begin(); it != expected.end();) {
+      if (odd(*it)) {
+        it = expected.erase(it);
+        ++removed;
+      } else {
+        ++it;
+      }
+    }
+    EXPECT_EQ(m1.erase_if(odd), removed);
+    ASSERT_EQ(m1.size(), expected.size());
+    auto it = m1.begin();
+    for (const auto &item : expected) {
+      EXPECT_EQ(it->first, item.first);
+      EXPECT_EQ(it->second, item.second);
+      ++it;
+    }
+  }
+}
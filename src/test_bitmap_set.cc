@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "s21_bitmap_set.h"
+
+TEST(bitmap_set_capacity, empty_00) {
+  s21::bitmap_set s;
+  ASSERT_EQ(s.empty(), true);
+  ASSERT_EQ(s.size(), 0);
+  ASSERT_EQ(s.begin() == s.end(), true);
+}
+
+TEST(bitmap_set_mod, insert_00) {
+  s21::bitmap_set s{5, 1, 70000, 3, 1};
+  ASSERT_EQ(s.size(), 4);
+  auto result = s.insert(2);
+  EXPECT_EQ(result.second, true);
+  EXPECT_EQ(*result.first, 2u);
+  EXPECT_EQ(s.insert(70000).second, false);
+  EXPECT_EQ(s.contains(70000), true);
+  EXPECT_EQ(s.contains(4), false);
+}
+
+TEST(bitmap_set_iter, ordered_00) {
+  s21::bitmap_set s{4000000000u, 7, 65536, 65535, 0, 131072};
+  std::set<unsigned> expected{4000000000u, 7, 65536, 65535, 0, 131072};
+  auto it = s.begin();
+  for (auto value : expected) {
+    ASSERT_EQ(*it, value);
+    ++it;
+  }
+  ASSERT_EQ(it == s.end(), true);
+  --it;
+  EXPECT_EQ(*it, 4000000000u);
+  --it;
+  EXPECT_EQ(*it, 131072u);
+}
+
+TEST(bitmap_set_mod, erase_00) {
+  s21::bitmap_set s{1, 2, 3, 100000};
+  EXPECT_EQ(s.erase(2), 1);
+  EXPECT_EQ(s.erase(2), 0);
+  s.erase(s.find(100000));
+  EXPECT_EQ(s.size(), 2);
+  EXPECT_EQ(s.contains(100000), false);
+  EXPECT_EQ(s.find(100000) == s.end(), true);
+}
+
+TEST(bitmap_set_mod, dense_chunk_00) {
+  s21::bitmap_set s;
+  std::set<unsigned> expected;
+  for (unsigned v = 0; v < 20000; v += 3) {
+    s.insert(v);
+    expected.insert(v);
+  }
+  ASSERT_EQ(s.size(), expected.size());
+  for (unsigned v = 0; v < 20000; v += 6) {
+    s.erase(v);
+    expected.erase(v);
+  }
+  ASSERT_EQ(s.size(), expected.size());
+  auto it = s.begin();
+  for (auto value : expected) {
+    ASSERT_EQ(*it, value);
+    ++it;
+  }
+}
+
+TEST(bitmap_set_mod, runs_00) {
+  s21::bitmap_set s;
+  for (unsigned v = 1000; v < 60000; ++v) s.insert(v);
+  s.run_optimize();
+  EXPECT_EQ(s.size(), 59000);
+  s.erase(30000);
+  s.insert(999);
+  s.insert(60000);
+  EXPECT_EQ(s.contains(30000), false);
+  EXPECT_EQ(s.contains(30001), true);
+  EXPECT_EQ(s.size(), 59001);
+  EXPECT_EQ(*s.begin(), 999u);
+  EXPECT_EQ(*--s.end(), 60000u);
+}
+
+TEST(bitmap_set_ops, set_algebra_00) {
+  s21::bitmap_set a, b;
+  std::set<unsigned> sa, sb;
+  for (unsigned v = 0; v < 200000; v += 7) a.insert(v), sa.insert(v);
+  for (unsigned v = 0; v < 200000; v += 5) b.insert(v), sb.insert(v);
+  for (unsigned v = 300000; v < 300010; ++v) b.insert(v), sb.insert(v);
+  auto u = a | b, i = a & b, d = a - b;
+  size_t union_size = 0, inter_size = 0, diff_size = 0;
+  for (auto v : sa) {
+    if (sb.count(v)) ++inter_size;
+    else ++diff_size;
+  }
+  union_size = sa.size() + sb.size() - inter_size;
+  EXPECT_EQ(u.size(), union_size);
+  EXPECT_EQ(i.size(), inter_size);
+  EXPECT_EQ(d.size(), diff_size);
+  EXPECT_EQ(i.contains(35), true);
+  EXPECT_EQ(d.contains(35), false);
+  EXPECT_EQ(d.contains(14), true);
+  EXPECT_EQ(u.contains(300005), true);
+  a |= b;
+  EXPECT_EQ(a == u, true);
+}
+
+TEST(bitmap_set_io, serialize_00) {
+  s21::bitmap_set s{1, 2, 3, 70000, 4000000000u};
+  for (unsigned v = 200000; v < 210000; ++v) s.insert(v);
+  for (unsigned v = 300000; v < 300500; ++v) s.insert(v);
+  s.run_optimize();
+  auto bytes = s.serialize();
+  s21::bitmap_set restored = s21::bitmap_set::deserialize(bytes);
+  EXPECT_EQ(restored == s, true);
+  EXPECT_EQ(restored.size(), s.size());
+  bytes.resize(bytes.size() - 1);
+  EXPECT_THROW(s21::bitmap_set::deserialize(bytes), std::invalid_argument);
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "s21_cache.h"
+
+TEST(lru_cache_mod, put_get_00) {
+  s21::lru_cache<int, std::string> c1(2);
+  EXPECT_TRUE(c1.empty());
+  EXPECT_EQ(c1.capacity(), 2U);
+  EXPECT_TRUE(c1.put(1, "a"));
+  EXPECT_TRUE(c1.put(2, "b"));
+  EXPECT_FALSE(c1.put(2, "B"));
+  EXPECT_EQ(*c1.get(2), "B");
+  EXPECT_EQ(c1.get(3), nullptr);
+  EXPECT_EQ(c1.size(), 2U);
+  EXPECT_THROW((s21::lru_cache<int, int>(0)), std::invalid_argument);
+}
+
+TEST(lru_cache_mod, evict_00) {
+  s21::lru_cache<int, int> c1(3);
+  std::vector<int> evicted;
+  c1.set_eviction_callback(
+      [&](const int &key, int &value) { evicted.push_back(key + value); });
+  c1.put(1, 10);
+  c1.put(2, 20);
+  c1.put(3, 30);
+  c1.get(1);
+  c1.put(4, 40);
+  EXPECT_FALSE(c1.contains(2));
+  // peek does not refresh 3, so it goes next.
+  EXPECT_EQ(*c1.peek(3), 30);
+  c1.put(5, 50);
+  EXPECT_FALSE(c1.contains(3));
+  EXPECT_EQ(evicted, (std::vector<int>{22, 33}));
+  EXPECT_TRUE(c1.erase(1));
+  EXPECT_FALSE(c1.erase(1));
+  c1.put(6, 60);
+  EXPECT_EQ(evicted.size(), 2U);
+  c1.clear();
+  EXPECT_TRUE(c1.empty());
+  c1.put(7, 70);
+  EXPECT_EQ(*c1.get(7), 70);
+}
+
+TEST(lru_cache_mod, release_00) {
+  s21::lru_cache<int, std::shared_ptr<int>> c1(2);
+  auto first = std::make_shared<int>(1);
+  auto second = std::make_shared<int>(2);
+  c1.put(1, first);
+  c1.put(2, second);
+  EXPECT_EQ(first.use_count(), 2);
+  c1.erase(1);
+  EXPECT_EQ(first.use_count(), 1);
+  c1.put(3, nullptr);
+  c1.put(4, nullptr);
+  EXPECT_EQ(second.use_count(), 1);
+  EXPECT_EQ(c1.size(), 2U);
+}
+
+TEST(lru_cache_mod, random_00) {
+  const std::size_t capacity = 64;
+  s21::lru_cache<int, int> c1(capacity);
+  std::list<std::pair<int, int>> order;
+  std::map<int, std::list<std::pair<int, int>>::iterator> where;
+  std::mt19937 gen(5);
+  std::uniform_int_distribution<int> keys(0, 200);
+  for (int round = 0; round < 50000; ++round) {
+    int key = keys(gen);
+    auto found = where.find(key);
+    switch (gen() % 3) {
+      case 0: {
+        int *value = c1.get(key);
+        ASSERT_EQ(value != nullptr, found != where.end());
+        if (value != nullptr) {
+          EXPECT_EQ(*value, found->second->second);
+          order.splice(order.begin(), order, found->second);
+        }
+        break;
+      }
+      case 1:
+        EXPECT_EQ(c1.put(key, round), found == where.end());
+        if (found != where.end()) {
+          found->second->second = round;
+          order.splice(order.begin(), order, found->second);
+        } else {
+          if (order.size() == capacity) {
+            where.erase(order.back().first);
+            order.pop_back();
+          }
+          order.emplace_front(key, round);
+          where[key] = order.begin();
+        }
+        break;
+      default:
+        EXPECT_EQ(c1.erase(key), found != where.end());
+        if (found != where.end()) {
+          order.erase(found->second);
+          where.erase(found);
+        }
+    }
+    ASSERT_EQ(c1.size(), order.size());
+  }
+}
+
+TEST(lfu_cache_mod, evict_00) {
+  s21::lfu_cache<int, int> c1(3);
+  c1.put(1, 1);
+  c1.put(2, 2);
+  c1.put(3, 3);
+  c1.get(1);
+  c1.get(1);
+  c1.get(2);
+  c1.get(3);
+  // 2 and 3 are tied at two uses; 2 was used less recently.
+  c1.put(4, 4);
+  EXPECT_FALSE(c1.contains(2));
+  EXPECT_TRUE(c1.contains(1));
+  // The newcomer has the fewest uses.
+  c1.put(5, 5);
+  EXPECT_FALSE(c1.contains(4));
+  EXPECT_TRUE(c1.contains(3));
+  c1.erase(5);
+  c1.put(6, 6);
+  c1.put(7, 7);
+  EXPECT_FALSE(c1.contains(6));
+  EXPECT_EQ(c1.size(), 3U);
+}
+
+TEST(slru_cache_mod, scan_00) {
+  s21::slru_cache<int, int> c1(100);
+  s21::lru_cache<int, int> c2(100);
+  for (int round = 0; round < 2; ++round) {
+    for (int key = 0; key < 50; ++key) {
+      if (c1.get(key) == nullptr) c1.put(key, key);
+      if (c2.get(key) == nullptr) c2.put(key, key);
+    }
+  }
+  for (int key = 1000; key < 1500; ++key) {
+    c1.put(key, key);
+    c2.put(key, key);
+  }
+  int kept = 0;
+  for (int key = 0; key < 50; ++key) kept += c1.contains(key);
+  EXPECT_EQ(kept, 50);
+  for (int key = 0; key < 50; ++key) EXPECT_FALSE(c2.contains(key));
+}
+
+TEST(slru_cache_mod, demote_00) {
+  s21::slru_cache<int, int> c1(5);
+  for (int key = 0; key < 5; ++key) c1.put(key, key);
+  for (int key = 0; key < 5; ++key) c1.get(key);
+  // Four protected slots: the oldest protected entry fell back to
+  // probation and is the next victim.
+  c1.put(5, 5);
+  EXPECT_FALSE(c1.contains(0));
+  for (int key = 1; key < 6; ++key) EXPECT_TRUE(c1.contains(key));
+}
+
+TEST(concurrent_cache_mod, threads_00) {
+  s21::concurrent_cache<s21::lru_cache<int, int>, 8> c1(256);
+  EXPECT_EQ(c1.capacity(), 256U);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&c1, t] {
+      for (int i = 0; i < 20000; ++i) {
+        int key = (i * 31 + t) % 1000;
+        if (i % 3 == 0) {
+          c1.put(key, key * 2);
+        } else if (std::optional<int> value = c1.get(key)) {
+          EXPECT_EQ(*value, key * 2);
+        }
+        if (i % 97 == 0) c1.erase(key);
+      }
+    });
+  }
+  for (std::thread &thread : threads) thread.join();
+  EXPECT_LE(c1.size(), 256U);
+  c1.put(1, 2);
+  EXPECT_EQ(c1.get(1).value(), 2);
+  EXPECT_TRUE(c1.contains(1));
+  c1.clear();
+  EXPECT_EQ(c1.size(), 0U);
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "s21_interval_map.h"
+
+namespace {
+using window = s21::interval<int>;
+
+// Checks stab and overlap queries against a linear scan while intervals are
+// inserted and erased at random, so the cached endpoints must survive every
+// kind of rebalancing.
+template <typename Balance>
+void checkAgainstScan() {
+  s21::interval_map<int, int, std::less<int>, Balance> m1;
+  std::vector<window> live;
+  unsigned seed = 11;
+  auto next = [&seed] {
+    seed = seed * 1103515245 + 12345;
+    return static_cast<int>((seed >> 16) % 1000);
+  };
+  for (int i = 0; i < 3000; ++i) {
+    int low = next();
+    window key{low, low + next() % 50};
+    if (i % 3 == 2 && !live.empty()) {
+      window victim = live[next() % live.size()];
+      EXPECT_EQ(m1.erase(victim), 1U);
+      for (auto it = live.begin(); it != live.end(); ++it) {
+        if (*it == victim) {
+          live.erase(it);
+          break;
+        }
+      }
+    } else if (m1.insert(key.low, key.high, i).second) {
+      live.push_back(key);
+    }
+    if (i % 100 == 0) {
+      int point = next();
+      window range{point, point + 20};
+      size_t stabbed = 0;
+      size_t overlapping = 0;
+      for (const window &w : live) {
+        stabbed += (w.low <= point && point <= w.high);
+        overlapping += (w.low <= range.high && range.low <= w.high);
+      }
+      size_t found = 0;
+      m1.stab(point, [&](const window &w, int &) {
+        EXPECT_EQ(w.low <= point && point <= w.high, true);
+        ++found;
+      });
+      EXPECT_EQ(found, stabbed);
+      EXPECT_EQ(m1.count_overlapping(range), overlapping);
+    }
+  }
+  EXPECT_EQ(m1.size(), live.size());
+}
+}  // namespace
+
+TEST(interval_map_capacity, empty_00) {
+  s21::interval_map<int, std::string> m1;
+  EXPECT_EQ(m1.empty(), true);
+  EXPECT_EQ(m1.count_overlapping({0, 100}), 0U);
+  EXPECT_EQ(m1.begin() == m1.end(), true);
+}
+
+TEST(interval_map_mod, insert_00) {
+  s21::interval_map<int, std::string> m1{{{10, 20}, "a"}, {{5, 8}, "b"}};
+  EXPECT_EQ(m1.insert(10, 20, "c").second, false);
+  EXPECT_EQ(m1.insert(10, 30, "c").second, true);
+  EXPECT_EQ(m1.at({10, 20}), "a");
+  EXPECT_EQ(m1.max_endpoint(), 30);
+  EXPECT_THROW(m1.insert(5, 4, "bad"), std::invalid_argument);
+  EXPECT_THROW(m1.at({1, 2}), std::out_of_range);
+  std::vector<int> lows;
+  for (auto it = m1.begin(); it != m1.end(); ++it) {
+    lows.push_back((*it).first.low);
+  }
+  EXPECT_EQ(lows, (std::vector<int>{5, 10, 10}));
+  EXPECT_EQ(m1.erase({10, 30}), 1U);
+  EXPECT_EQ(m1.max_endpoint(), 20);
+}
+
+TEST(interval_map_lookup, stab_00) {
+  s21::interval_map<int, std::string> m1{
+      {{1, 5}, "a"}, {{3, 9}, "b"}, {{6, 7}, "c"}, {{10, 12}, "d"}};
+  std::string hits;
+  m1.stab(6, [&](const window &, std::string &value) { hits += value; });
+  EXPECT_EQ(hits, "bc");
+  hits.clear();
+  m1.stab(5, [&](const window &, std::string &value) { hits += value; });
+  EXPECT_EQ(hits, "ab");
+  hits.clear();
+  m1.overlap({8, 10}, [&](const window &, std::string &value) {
+    hits += value;
+    value += "!";
+  });
+  EXPECT_EQ(hits, "bd");
+  EXPECT_EQ(m1.at({10, 12}), "d!");
+  EXPECT_EQ(m1.count_overlapping({13, 20}), 0U);
+}
+
+TEST(interval_map_lookup, against_scan_00) {
+  checkAgainstScan<s21::avl_balance>();
+  checkAgainstScan<s21::red_black_balance>();
+  checkAgainstScan<s21::weight_balance>();
+  checkAgainstScan<s21::threaded<s21::avl_balance>>();
+}
+
+TEST(interval_map_mod, copy_00) {
+  s21::interval_map<double, int> m1{{{0.5, 1.5}, 1}, {{1.0, 4.0}, 2}};
+  s21::interval_map<double, int> m2(m1);
+  m1.clear();
+  EXPECT_EQ(m2.count_overlapping({1.2, 1.2}), 2U);
+  EXPECT_EQ(m2.max_endpoint(), 4.0);
+  s21::interval_map<double, int> m3(std::move(m2));
+  EXPECT_EQ(m3.size(), 2U);
+  m3.swap(m1);
+  EXPECT_EQ(m1.size(), 2U);
+  EXPECT_EQ(m3.empty(), true);
+}
+
+namespace {
+struct endpointOrder {
+  bool descending = false;
+  bool operator()(int a, int b) const { return descending ? b < a : a < b; }
+};
+}  // namespace
+
+TEST(interval_map_lookup, comparator_00) {
+  s21::interval_map<int, int, endpointOrder> m1(endpointOrder{true});
+  for (int i = 0; i < 200; ++i) m1.insert(1000 - i * 5, 1000 - i * 5 - 12, i);
+  EXPECT_THROW(m1.insert(1, 2, 0), std::invalid_argument);
+  // The largest endpoint under the descending order.
+  EXPECT_EQ(m1.max_endpoint(), 5 - 12);
+  size_t found = 0;
+  m1.stab(500, [&](const s21::interval<int> &w, int &) {
+    EXPECT_EQ(w.low >= 500 && 500 >= w.high, true);
+    ++found;
+  });
+  EXPECT_EQ(found, 3U);
+  EXPECT_EQ(m1.count_overlapping({900, 880}), 7U);
+  EXPECT_EQ((*m1.begin()).first.low, 1000);
+}
@@ -547,4 +547,17 @@ TEST(list, swap_empty) {
   our1.swap(our);
   EXPECT_EQ(our1.front(), 1);
   EXPECT_EQ(our1.back(), 4);
-}
\ No newline at end of file
+}TEST(list, moved_from_reuse) {
+  s21::list<int> our{1, 2, 3};
+  s21::list<int> our1(std::move(our));
+  EXPECT_TRUE(our.empty());
+  EXPECT_TRUE(our.begin() == our.end());
+  our.push_back(5);
+  EXPECT_EQ(our.front(), 5);
+  EXPECT_EQ(our1.size(), 3U);
+  int expected = 1;
+  for (auto it = our1.begin(); it != our1.end(); ++it) {
+    EXPECT_EQ(*it, expected++);
+  }
+  EXPECT_EQ(expected, 4);
+}
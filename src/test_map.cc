@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <fstream>
 #include <ostream>
 
 #include "s21_map.h"
@@ -117,4 +118,665 @@ class Hui {
 
 void Hui::print() {
   
-}
\ No newline at end of file
+}
+TEST(map_compare, custom_00) {
+  s21::map<std::string, int, std::greater<std::string>> m1{
+      {"One", 1}, {"Two", 2}, {"Three", 3}};
+  auto it = m1.begin();
+  EXPECT_EQ((*it).first, "Two");
+  EXPECT_EQ((*++it).first, "Three");
+  EXPECT_EQ(m1.at("One"), 1);
+  EXPECT_EQ(m1.value_comp()({"b", 0}, {"a", 0}), true);
+}
+
+TEST(map_bloom, negative_lookups_00) {
+  s21::map<std::string, int> m1{{"One", 1}, {"Two", 2}};
+  m1.enable_bloom_filter(0.001);
+  m1.insert("Three", 3);
+  EXPECT_EQ(m1.contains("Three"), true);
+  EXPECT_EQ(m1.contains("Four"), false);
+  EXPECT_EQ(m1.bloom_filter_stats().lookups, 2);
+  s21::map<std::string, int> m2;
+  m2.swap(m1);
+  EXPECT_EQ(m2.bloom_filter_enabled(), true);
+  EXPECT_EQ(m1.bloom_filter_enabled(), false);
+}
+
+TEST(map_cache, hot_keys_00) {
+  s21::map<int, int> m1;
+  for (int i = 0; i < 100; ++i) m1.insert(i, i * 10);
+  m1.enable_lookup_cache(16);
+  for (int round = 0; round < 10; ++round) {
+    EXPECT_EQ(m1.at(7), 70);
+    EXPECT_EQ(m1[42], 420);
+  }
+  auto stats = m1.lookup_cache_stats();
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.hits, 18);
+  m1.at(7) = 71;
+  EXPECT_EQ(m1.at(7), 71);
+  EXPECT_THROW(m1.at(1000), std::out_of_range);
+}
+
+TEST(map_cache, invalidation_00) {
+  s21::map<int, int> m1{{1, 10}, {2, 20}, {3, 30}};
+  m1.enable_lookup_cache();
+  EXPECT_EQ(m1.at(2), 20);
+  auto it = m1.begin();
+  m1.erase(++it);
+  EXPECT_EQ(m1.contains(2), false);
+  EXPECT_THROW(m1.at(2), std::out_of_range);
+  m1.insert(2, 22);
+  EXPECT_EQ(m1.at(2), 22);
+  EXPECT_EQ(m1.at(3), 30);
+  m1.clear();
+  EXPECT_EQ(m1.contains(3), false);
+  m1.insert(3, 33);
+  EXPECT_EQ(m1.at(3), 33);
+  s21::map<int, int> m2(m1);
+  EXPECT_EQ(m2.lookup_cache_enabled(), true);
+  EXPECT_EQ(m2.at(3), 33);
+}
+
+TEST(map_balance, policies_00) {
+  s21::map<int, int, std::less<int>, s21::weight_balance> m1;
+  s21::map<int, int, std::less<int>, s21::red_black_balance> m2;
+  for (int i = 0; i < 100; ++i) {
+    m1.insert(i, -i);
+    m2.insert(i, -i);
+  }
+  EXPECT_EQ(m1.at(64), -64);
+  EXPECT_EQ(m2.at(64), -64);
+  m1.erase(m1.begin());
+  EXPECT_EQ((*m1.begin()).first, 1);
+}
+
+TEST(map_access, find_00) {
+  s21::map<std::string, int> m1{{"One", 1}, {"Two", 2}};
+  EXPECT_EQ((*m1.find("Two")).second, 2);
+  EXPECT_EQ(m1.find("Three") == m1.end(), true);
+  *m1.try_get("One") = 11;
+  EXPECT_EQ(m1.at("One"), 11);
+  EXPECT_EQ(m1.try_get("Three"), nullptr);
+  EXPECT_EQ(m1.get_or("Three", 3), 3);
+  EXPECT_EQ(m1.get_or("Two", 3), 2);
+  EXPECT_THROW(m1.at("Three"), std::out_of_range);
+}
+
+TEST(map_upsert, operator_00) {
+  s21::map<std::string, int> m1;
+  for (const char* word : {"a", "b", "a", "c", "a", "b"}) ++m1[word];
+  EXPECT_EQ(m1.size(), 3U);
+  EXPECT_EQ(m1.at("a"), 3);
+  EXPECT_EQ(m1.at("b"), 2);
+  EXPECT_EQ(m1.at("c"), 1);
+}
+
+TEST(map_upsert, try_emplace_00) {
+  s21::map<int, std::string> m1;
+  auto result = m1.try_emplace(1, 3, 'x');
+  EXPECT_EQ(result.second, true);
+  EXPECT_EQ((*result.first).second, "xxx");
+  result = m1.try_emplace(1, 5, 'y');
+  EXPECT_EQ(result.second, false);
+  EXPECT_EQ(m1.at(1), "xxx");
+  result = m1.insert_or_assign(1, "z");
+  EXPECT_EQ(result.second, false);
+  EXPECT_EQ(m1.at(1), "z");
+}
+
+TEST(map_upsert, upsert_00) {
+  s21::map<int, int> m1;
+  m1.enable_bloom_filter();
+  m1.enable_lookup_cache(16);
+  for (int i = 0; i < 300; ++i) {
+    m1.upsert(i % 7, [](int& count) { count += 2; });
+  }
+  EXPECT_EQ(m1.size(), 7U);
+  EXPECT_EQ(m1.at(0), 2 * 43);
+  EXPECT_EQ(m1.at(6), 2 * 42);
+  EXPECT_GT(m1.lookup_cache_stats().hits, 0U);
+  EXPECT_EQ(m1.contains(7), false);
+}
+
+TEST(map_upsert, compute_00) {
+  s21::map<int, int> m1{{1, 10}};
+  auto doubled = [](int key, const int* current) {
+    return current != nullptr ? *current * 2 : key;
+  };
+  EXPECT_EQ(m1.compute(1, doubled).second, false);
+  EXPECT_EQ(m1.at(1), 20);
+  EXPECT_EQ(m1.compute(5, doubled).second, true);
+  EXPECT_EQ(m1.at(5), 5);
+  m1.clear();
+  m1.compute(3, doubled);
+  EXPECT_EQ(m1.at(3), 3);
+}
+
+TEST(map_batch, apply_00) {
+  s21::map<int, int> m1;
+  m1.enable_lookup_cache(16);
+  std::vector<s21::map<int, int>::update_type> updates;
+  for (int i = 0; i < 100; ++i) {
+    updates.push_back({s21::batch_op::insert, {i, i}});
+  }
+  m1.apply_batch(updates);
+  EXPECT_EQ(m1.at(50), 50);
+  m1.apply_batch({{s21::batch_op::insert, {50, -50}},
+                  {s21::batch_op::erase, {7, 0}},
+                  {s21::batch_op::insert, {200, 2}},
+                  {s21::batch_op::insert, {50, -51}}});
+  EXPECT_EQ(m1.at(50), -51);
+  EXPECT_EQ(m1.contains(7), false);
+  EXPECT_EQ(m1.at(200), 2);
+  EXPECT_EQ(m1.size(), 100U);
+  EXPECT_EQ(m1.erase_if([](const std::pair<int, int>& item) {
+    return item.second < 0;
+  }), 1U);
+  EXPECT_EQ(m1.contains(50), false);
+  EXPECT_EQ((*m1.begin()).first, 0);
+}
+
+TEST(map_compact, compact_00) {
+  s21::map<int, std::string> m1;
+  m1.enable_lookup_cache(8);
+  for (int i = 0; i < 200; ++i) m1[i] = std::to_string(i);
+  EXPECT_EQ(m1.at(5), "5");
+  m1.compact(s21::node_layout::van_emde_boas);
+  EXPECT_EQ(m1.at(5), "5");
+  m1.erase(m1.find(5));
+  EXPECT_EQ(m1.contains(5), false);
+  s21::map<int, std::string> m2(m1);
+  m1.compact();
+  EXPECT_EQ(m2.at(199), "199");
+  EXPECT_EQ(m1.at(199), "199");
+}
+
+TEST(map_iter, for_each_in_range_00) {
+  s21::map<int, int, std::less<int>, s21::threaded<s21::red_black_balance>>
+      m1;
+  for (int i = 0; i < 100; ++i) m1[i] = i;
+  m1.for_each_in_range(20, 25, [](std::pair<int, int>& item) {
+    item.second *= 10;
+  });
+  EXPECT_EQ(m1.at(19), 19);
+  EXPECT_EQ(m1.at(20), 200);
+  EXPECT_EQ(m1.at(24), 240);
+  EXPECT_EQ(m1.at(25), 25);
+}
+
+TEST(map_copy, large_00) {
+  s21::map<int, std::string> m1;
+  for (int i = 0; i < 80000; ++i) m1[i] = std::to_string(i);
+  s21::map<int, std::string> m2(m1);
+  m1.set_background_reclaim(true);
+  m1.clear();
+  EXPECT_EQ(m2.at(77777), "77777");
+  EXPECT_EQ(m2.size(), 80000U);
+  s21::Reclaimer::instance().drain();
+}
+
+namespace {
+// String concatenation is not commutative, so it checks that ranges are
+// combined in key order.
+struct concat_monoid {
+  using value_type = std::string;
+  static std::string identity() { return ""; }
+  static std::string combine(const std::string& a, const std::string& b) {
+    return a + b;
+  }
+};
+
+template <typename Balance>
+void checkRangeSums() {
+  s21::map<int, long, std::less<int>, s21::aggregated<s21::sum_monoid<long>,
+                                                      Balance>>
+      m1;
+  std::map<int, long> expected;
+  unsigned seed = 5;
+  auto next = [&seed] {
+    seed = seed * 1103515245 + 12345;
+    return static_cast<int>((seed >> 16) % 500);
+  };
+  for (int i = 0; i < 2000; ++i) {
+    int key = next();
+    if (i % 4 == 3) {
+      auto victim = expected.lower_bound(key);
+      if (victim != expected.end()) {
+        m1.erase(m1.find(victim->first));
+        expected.erase(victim);
+      }
+    } else {
+      m1.insert_or_assign(key, i);
+      expected[key] = i;
+    }
+    if (i % 50 == 0) {
+      int lo = next();
+      int hi = lo + next() / 4;
+      long sum = 0;
+      for (auto it = expected.lower_bound(lo);
+           it != expected.end() && it->first < hi; ++it) {
+        sum += it->second;
+      }
+      EXPECT_EQ(m1.aggregate(lo, hi), sum);
+    }
+  }
+  std::vector<typename decltype(m1)::update_type> batch;
+  for (int key = 0; key < 500; key += 7) {
+    batch.push_back({s21::batch_op::insert, {key, 1}});
+    expected[key] = 1;
+  }
+  m1.apply_batch(batch);
+  long total = 0;
+  for (const auto& item : expected) total += item.second;
+  EXPECT_EQ(m1.aggregate(-1, 1000), total);
+}
+}  // namespace
+
+TEST(map_aggregate, sum_00) {
+  checkRangeSums<s21::avl_balance>();
+  checkRangeSums<s21::red_black_balance>();
+  checkRangeSums<s21::weight_balance>();
+}
+
+TEST(map_aggregate, min_max_00) {
+  s21::map<int, int, std::less<int>, s21::aggregated<s21::min_monoid<int>>>
+      lows{{1, 5}, {2, 3}, {3, 8}, {4, 1}};
+  s21::map<int, int, std::less<int>, s21::aggregated<s21::max_monoid<int>>>
+      highs{{1, 5}, {2, 3}, {3, 8}, {4, 1}};
+  EXPECT_EQ(lows.aggregate(1, 4), 3);
+  EXPECT_EQ(lows.aggregate(1, 5), 1);
+  EXPECT_EQ(highs.aggregate(1, 3), 5);
+  EXPECT_EQ(highs.aggregate(5, 9), std::numeric_limits<int>::lowest());
+  lows[3] = -2;
+  lows.refresh(3);
+  EXPECT_EQ(lows.aggregate(1, 4), -2);
+  lows.upsert(2, [](int& value) { value = -7; });
+  EXPECT_EQ(lows.aggregate(0, 3), -7);
+}
+
+TEST(map_aggregate, order_00) {
+  s21::map<int, std::string, std::less<int>,
+           s21::aggregated<concat_monoid, s21::red_black_balance>>
+      m1;
+  for (int i = 0; i < 26; ++i) {
+    m1.insert((i * 7) % 26, std::string(1, 'a' + (i * 7) % 26));
+  }
+  EXPECT_EQ(m1.aggregate(0, 26), "abcdefghijklmnopqrstuvwxyz");
+  EXPECT_EQ(m1.aggregate(3, 9), "defghi");
+  EXPECT_EQ(m1.aggregate(9, 3), "");
+  m1.compute(4, [](int, const std::string*) { return std::string("E"); });
+  EXPECT_EQ(m1.aggregate(3, 6), "dEf");
+}
+
+TEST(map_merkle, same_contents_00) {
+  using merkle_map =
+      s21::map<int, std::string, std::less<int>, s21::merkle<>>;
+  merkle_map m1;
+  merkle_map m2;
+  for (int i = 0; i < 300; ++i) m1.insert(i, std::to_string(i));
+  for (int i = 299; i >= 0; --i) m2.insert(i, std::to_string(i));
+  EXPECT_EQ(m1.same_contents(m2), true);
+  m2.insert_or_assign(150, "changed");
+  EXPECT_EQ(m1.same_contents(m2), false);
+  m2.insert_or_assign(150, "150");
+  EXPECT_EQ(m1.same_contents(m2), true);
+  m2.erase(m2.find(7));
+  EXPECT_EQ(m1.same_contents(m2), false);
+  EXPECT_EQ(merkle_map().same_contents(merkle_map()), true);
+}
+
+TEST(map_merkle, diff_00) {
+  using merkle_map =
+      s21::map<int, int, std::less<int>, s21::merkle<s21::red_black_balance>>;
+  merkle_map m1;
+  for (int i = 0; i < 5000; ++i) m1.insert(i * 3, i);
+  merkle_map m2(m1);
+  EXPECT_EQ(m1.diff(m2).empty(), true);
+  m2.erase(m2.find(300));
+  m2.insert(301, 1);
+  m2.insert_or_assign(9000, -1);
+  std::vector<merkle_map::update_type> updates = m1.diff(m2);
+  ASSERT_EQ(updates.size(), 3U);
+  m2.apply_batch(updates);
+  EXPECT_EQ(m2.same_contents(m1), true);
+  EXPECT_EQ(m2.contains(301), false);
+  EXPECT_EQ(m2.at(9000), 3000);
+  merkle_map empty;
+  EXPECT_EQ(empty.diff(m1).size(), m1.size());
+  EXPECT_EQ(m1.diff(empty).size(), m1.size());
+  empty.apply_batch(m1.diff(empty));
+  EXPECT_EQ(empty.same_contents(m1), true);
+}
+
+TEST(map_merkle, diff_01) {
+  using merkle_map = s21::map<int, int, std::less<int>, s21::merkle<>>;
+  merkle_map m1;
+  merkle_map m2;
+  std::map<int, int> expected1;
+  std::map<int, int> expected2;
+  unsigned seed = 3;
+  auto next = [&seed] {
+    seed = seed * 1103515245 + 12345;
+    return static_cast<int>((seed >> 16) % 400);
+  };
+  for (int i = 0; i < 600; ++i) {
+    int key = next();
+    m1.insert_or_assign(key, i % 7);
+    expected1[key] = i % 7;
+    key = next();
+    m2.insert_or_assign(key, i % 5);
+    expected2[key] = i % 5;
+  }
+  size_t differing = 0;
+  for (int key = 0; key < 400; ++key) {
+    auto a = expected1.find(key);
+    auto b = expected2.find(key);
+    bool inA = a != expected1.end();
+    bool inB = b != expected2.end();
+    differing += (inA != inB) || (inA && a->second != b->second);
+  }
+  std::vector<merkle_map::update_type> updates = m1.diff(m2);
+  EXPECT_EQ(updates.size(), differing);
+  m2.apply_batch(updates);
+  EXPECT_EQ(m2.same_contents(m1), true);
+  EXPECT_EQ(m2.size(), m1.size());
+}
+
+TEST(map_txn, rollback_00) {
+  s21::map<int, std::string> m1{{1, "one"}, {2, "two"}, {3, "three"}};
+  m1.begin_txn();
+  EXPECT_EQ(m1.in_txn(), true);
+  EXPECT_THROW(m1.begin_txn(), std::logic_error);
+  m1.insert(4, "four");
+  m1.insert_or_assign(1, "ONE");
+  m1.modify(2, [](std::string& value) { value = "TWO"; });
+  m1.modify(3, [](std::string& value) { value += "!"; });
+  m1.erase(m1.find(4));
+  m1.erase(m1.find(1));
+  m1.upsert(5, [](std::string& value) { value = "five"; });
+  m1.rollback();
+  EXPECT_EQ(m1.in_txn(), false);
+  EXPECT_EQ(m1.size(), 3U);
+  EXPECT_EQ(m1.at(1), "one");
+  EXPECT_EQ(m1.at(2), "two");
+  EXPECT_EQ(m1.at(3), "three");
+  EXPECT_EQ(m1.contains(5), false);
+  EXPECT_THROW(m1.commit(), std::logic_error);
+  EXPECT_THROW(m1.savepoint(), std::logic_error);
+}
+
+TEST(map_txn, accessors_00) {
+  s21::map<int, int> m1{{1, 10}, {2, 20}, {3, 30}};
+  m1.begin_txn();
+  const s21::map<int, int>& reader = m1;
+  auto mark = m1.savepoint();
+  // Reads log nothing, through the const and the mutable overloads.
+  EXPECT_EQ(reader.at(1), 10);
+  EXPECT_EQ(*reader.try_get(2), 20);
+  EXPECT_EQ(reader.try_get(4), nullptr);
+  EXPECT_EQ(reader.get_or(4, -1), -1);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(m1.at(1) + *m1.try_get(2) + m1[3], 60);
+  }
+  EXPECT_EQ(m1.savepoint(), mark);
+  EXPECT_EQ(m1.modify(1, [](int& value) { value = 11; }), true);
+  EXPECT_EQ(m1.modify(4, [](int& value) { value = 44; }), false);
+  EXPECT_EQ(m1.savepoint(), mark + 1);
+  // Writes through accessors and iterators are not logged.
+  m1.at(2) = 22;
+  (*m1.find(3)).second = 33;
+  EXPECT_EQ(m1.savepoint(), mark + 1);
+  m1.rollback();
+  EXPECT_EQ(m1.at(1), 10);
+  EXPECT_EQ(m1.at(2), 22);
+  EXPECT_EQ(m1.at(3), 33);
+}
+
+TEST(map_txn, move_00) {
+  s21::map<int, int> m1{{1, 10}, {2, 20}};
+  s21::map<int, int> m2{{7, 70}};
+  s21::map<int, int>& alias = m1;
+  m1 = std::move(alias);
+  EXPECT_EQ(m1.at(2), 20);
+  m1.begin_txn();
+  m2.begin_txn();
+  m2 = std::move(m1);
+  EXPECT_EQ(m1.empty(), true);
+  EXPECT_EQ(m2.at(1), 10);
+  m1.rollback();
+  m2.rollback();
+  EXPECT_EQ(m1.size(), 2U);
+  EXPECT_EQ(m2.size(), 1U);
+  EXPECT_EQ(m2.at(7), 70);
+}
+
+TEST(map_txn, savepoint_00) {
+  s21::map<int, int> m1;
+  for (int i = 0; i < 100; ++i) m1.insert(i, i);
+  m1.begin_txn();
+  m1.erase_if([](const std::pair<int, int>& item) { return item.first < 50; });
+  auto mark = m1.savepoint();
+  m1.apply_batch({{s21::batch_op::insert, {200, 1}},
+                  {s21::batch_op::insert, {60, -60}},
+                  {s21::batch_op::erase, {70, 0}}});
+  m1.compute(80, [](int, const int* current) { return *current * 2; });
+  EXPECT_EQ(m1.at(60), -60);
+  m1.rollback(mark);
+  EXPECT_EQ(m1.in_txn(), true);
+  EXPECT_EQ(m1.size(), 50U);
+  EXPECT_EQ(m1.at(60), 60);
+  EXPECT_EQ(m1.at(70), 70);
+  EXPECT_EQ(m1.at(80), 80);
+  EXPECT_EQ(m1.contains(200), false);
+  m1.clear();
+  m1.commit();
+  EXPECT_EQ(m1.empty(), true);
+  EXPECT_THROW(m1.rollback(mark), std::logic_error);
+}
+
+TEST(map_txn, rollback_01) {
+  s21::map<int, int, std::less<int>, s21::aggregated<s21::sum_monoid<int>>>
+      m1{{1, 10}, {2, 20}};
+  s21::map<int, int, std::less<int>, s21::aggregated<s21::sum_monoid<int>>>
+      m2{{7, 70}};
+  m1.begin_txn();
+  m1.insert_or_assign(1, 100);
+  m1 = m2;
+  EXPECT_EQ(m1.aggregate(0, 10), 70);
+  m1.rollback(0);
+  EXPECT_EQ(m1.aggregate(0, 10), 30);
+  EXPECT_EQ(m1.contains(7), false);
+  m1.commit();
+}
+
+namespace {
+template <typename Map>
+void expectSameElements(Map& a, Map& b) {
+  ASSERT_EQ(a.size(), b.size());
+  for (auto it = a.begin(), other = b.begin(); it != a.end(); ++it, ++other) {
+    EXPECT_EQ((*it).first, (*other).first);
+    EXPECT_EQ((*it).second, (*other).second);
+  }
+}
+}  // namespace
+
+TEST(map_checkpoint, recover_00) {
+  std::string path = ::testing::TempDir() + "s21_map_checkpoint_00";
+  s21::map<int, std::string> m1;
+  for (int i = 0; i < 1000; ++i) m1.insert(i, std::to_string(i));
+  m1.enable_checkpoints(path);
+  m1.insert_or_assign(5, "five");
+  m1.erase(m1.find(6));
+  m1[2000] = "new";
+  m1.modify(5, [](std::string& value) { value = "FIVE"; });
+  EXPECT_EQ(m1.checkpoint(), 3U);
+  EXPECT_EQ(m1.checkpoint(), 0U);
+  auto m2 = s21::map<int, std::string>::recover(path);
+  expectSameElements(m1, m2);
+  m1.erase_if(
+      [](const std::pair<int, std::string>& item) { return item.first < 10; });
+  m1.apply_batch({{s21::batch_op::insert, {3, "three"}},
+                  {s21::batch_op::erase, {999, ""}}});
+  m1.compact_checkpoints(false);
+  EXPECT_EQ(m1.checkpoint(), 10U);
+  auto m3 = s21::map<int, std::string>::recover(path);
+  expectSameElements(m1, m3);
+  EXPECT_EQ(m3.checkpoints_enabled(), true);
+  m3.insert(-1, "minus");
+  m3.checkpoint();
+  auto m4 = s21::map<int, std::string>::recover(path);
+  expectSameElements(m3, m4);
+}
+
+TEST(map_checkpoint, background_00) {
+  std::string path = ::testing::TempDir() + "s21_map_checkpoint_01";
+  s21::map<int, int> m1;
+  m1.enable_checkpoints(path);
+  for (int round = 0; round < 5; ++round) {
+    for (int i = 0; i < 2000; ++i) m1.insert_or_assign(i * 7 % 3000, round);
+    m1.erase(m1.begin());
+    m1.checkpoint();
+    m1.compact_checkpoints();
+  }
+  m1.insert_or_assign(1, 1);
+  m1.checkpoint();
+  m1.wait_for_checkpoints();
+  auto m2 = s21::map<int, int>::recover(path);
+  expectSameElements(m1, m2);
+  m1.begin_txn();
+  m1.clear();
+  m1.rollback();
+  m1.checkpoint();
+  auto m3 = s21::map<int, int>::recover(path);
+  expectSameElements(m1, m3);
+}
+
+TEST(map_checkpoint, dirty_00) {
+  std::string path = ::testing::TempDir() + "s21_map_checkpoint_03";
+  s21::map<int, int> m1{{1, 1}, {2, 2}, {3, 3}};
+  m1.enable_checkpoints(path);
+  for (int i = 0; i < 1000; ++i) m1.insert_or_assign(1, i);
+  const s21::map<int, int>& reader = m1;
+  EXPECT_EQ(reader.at(2), 2);
+  EXPECT_EQ(*reader.try_get(3), 3);
+  EXPECT_EQ(m1.at(2) + *m1.try_get(3) + m1[2], 7);
+  EXPECT_EQ(m1.checkpoint(), 1U);
+  m1.modify(2, [](int& value) { value = 20; });
+  // Not recorded until the key is marked through modify.
+  m1.at(3) = 30;
+  EXPECT_EQ(m1.checkpoint(), 1U);
+  m1.modify(3, [](int&) {});
+  EXPECT_EQ(m1.checkpoint(), 1U);
+  m1.compact_checkpoints();
+  // Enabling again waits for the background merge of the old files.
+  m1.insert(4, 4);
+  m1.enable_checkpoints(path);
+  EXPECT_EQ(m1.checkpoint(), 0U);
+  auto m2 = s21::map<int, int>::recover(path);
+  expectSameElements(m1, m2);
+}
+
+namespace {
+struct keyOrder {
+  bool reverse = false;
+  bool operator()(int a, int b) const { return reverse ? b < a : a < b; }
+};
+}  // namespace
+
+TEST(map_checkpoint, comparator_00) {
+  std::string path = ::testing::TempDir() + "s21_map_checkpoint_04";
+  using map_type = s21::map<int, int, keyOrder>;
+  map_type m1(keyOrder{true});
+  for (int i = 0; i < 100; ++i) m1.insert(i, i);
+  m1.enable_checkpoints(path);
+  for (int i = 0; i < 100; i += 3) m1.insert_or_assign(i, -i);
+  m1.erase(m1.find(50));
+  m1.checkpoint();
+  m1.compact_checkpoints(false);
+  m1.insert_or_assign(7, 700);
+  m1.checkpoint();
+  auto m2 = map_type::recover(path, keyOrder{true});
+  EXPECT_EQ((*m2.begin()).first, 99);
+  expectSameElements(m1, m2);
+}
+
+namespace {
+// Value whose checkpoint encoding fails after its first byte when asked to.
+struct flakyValue {
+  int value;
+  bool operator==(const flakyValue& other) const {
+    return value == other.value;
+  }
+};
+
+bool failFlakyWrites = false;
+}  // namespace
+
+namespace s21 {
+template <>
+struct checkpoint_codec<flakyValue> {
+  static void write(std::ostream& out, const flakyValue& v) {
+    out.put(static_cast<char>(v.value));
+    if (failFlakyWrites) throw std::runtime_error("flaky write");
+    out.write(reinterpret_cast<const char*>(&v.value) + 1, sizeof(int) - 1);
+  }
+
+  static bool read(std::istream& in, flakyValue& v) {
+    return static_cast<bool>(
+        in.read(reinterpret_cast<char*>(&v.value), sizeof(int)));
+  }
+};
+}  // namespace s21
+
+TEST(map_checkpoint, torn_00) {
+  std::string path = ::testing::TempDir() + "s21_map_checkpoint_05";
+  using map_type = s21::map<int, flakyValue>;
+  map_type m1{{1, {1}}};
+  m1.enable_checkpoints(path);
+  m1.insert(2, {2});
+  m1.checkpoint();
+  {
+    std::ofstream torn(path + ".delta", std::ios::app | std::ios::binary);
+    torn.put(0);
+    torn.put(7);
+  }
+  // The recovered map checkpoints a change, which a second recovery keeps.
+  auto m2 = map_type::recover(path);
+  m2.insert(3, {3});
+  m2.checkpoint();
+  auto m3 = map_type::recover(path);
+  EXPECT_EQ(m3.size(), 3U);
+  EXPECT_EQ(m3.get_or(3, {0}).value, 3);
+  // A failed checkpoint leaves no partial record behind.
+  m3.insert(4, {4});
+  failFlakyWrites = true;
+  EXPECT_THROW(m3.checkpoint(), std::runtime_error);
+  failFlakyWrites = false;
+  m3.insert(5, {5});
+  EXPECT_EQ(m3.checkpoint(), 2U);
+  auto m4 = map_type::recover(path);
+  EXPECT_EQ(m4.size(), 5U);
+  EXPECT_EQ(m4.at(4).value, 4);
+  EXPECT_EQ(m4.at(5).value, 5);
+}
+
+TEST(map_checkpoint, errors_00) {
+  std::string path = ::testing::TempDir() + "s21_map_checkpoint_02";
+  using map_type = s21::map<int, int>;
+  EXPECT_THROW(map_type::recover(path + "_missing"), std::runtime_error);
+  map_type m1{{1, 1}};
+  EXPECT_THROW(m1.checkpoint(), std::logic_error);
+  m1.enable_checkpoints(path);
+  m1.insert(2, 2);
+  m1.checkpoint();
+  {
+    std::ofstream torn(path + ".delta", std::ios::app | std::ios::binary);
+    torn.put(0);
+    torn.put(7);
+  }
+  auto m2 = map_type::recover(path);
+  expectSameElements(m1, m2);
+  m1.disable_checkpoints();
+  EXPECT_EQ(m1.checkpoints_enabled(), false);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "s21_multi_index.h"
+
+struct Record {
+  int id;
+  long timestamp;
+  std::string name;
+};
+
+using records = s21::multi_index<Record, s21::ordered_unique<&Record::id>,
+                                 s21::ordered_non_unique<&Record::timestamp>,
+                                 s21::hashed_non_unique<&Record::name>>;
+
+TEST(multi_index_mod, insert_00) {
+  records r;
+  EXPECT_EQ(r.empty(), true);
+  EXPECT_EQ(r.insert({1, 100, "a"}).second, true);
+  EXPECT_EQ(r.insert({2, 100, "b"}).second, true);
+  EXPECT_EQ(r.insert({3, 50, "a"}).second, true);
+  auto result = r.insert({2, 10, "c"});
+  EXPECT_EQ(result.second, false);
+  EXPECT_EQ(result.first->name, "b");
+  EXPECT_EQ(r.size(), 3U);
+  EXPECT_EQ(r.get<0>().size(), 3U);
+  EXPECT_EQ(r.get<1>().size(), 3U);
+  EXPECT_EQ(r.get<2>().size(), 3U);
+  EXPECT_EQ(r.get<1>().contains(10), false);
+}
+
+TEST(multi_index_lookup, ordered_00) {
+  records r{{5, 30, "x"}, {1, 10, "y"}, {3, 30, "z"}, {4, 20, "x"}};
+  auto& by_id = r.get<0>();
+  EXPECT_EQ(by_id.find(3)->name, "z");
+  EXPECT_EQ(by_id.find(2) == by_id.end(), true);
+  int expected[] = {1, 3, 4, 5};
+  int i = 0;
+  for (const Record& record : by_id) EXPECT_EQ(record.id, expected[i++]);
+  auto it = by_id.end();
+  EXPECT_EQ((--it)->id, 5);
+  EXPECT_EQ(by_id.lower_bound(2)->id, 3);
+  EXPECT_EQ(by_id.upper_bound(4)->id, 5);
+
+  auto& by_time = r.get<1>();
+  EXPECT_EQ(by_time.count(30), 2U);
+  auto range = by_time.equal_range(30);
+  int ids = 0;
+  for (auto at = range.first; at != range.second; ++at) ids += at->id;
+  EXPECT_EQ(ids, 8);
+  EXPECT_EQ(by_time.find(20)->id, 4);
+}
+
+TEST(multi_index_lookup, hashed_00) {
+  records r;
+  for (int i = 0; i < 100; ++i) {
+    r.insert({i, i, "n" + std::to_string(i % 10)});
+  }
+  auto& by_name = r.get<2>();
+  EXPECT_EQ(by_name.count("n3"), 10U);
+  EXPECT_EQ(by_name.contains("n10"), false);
+  EXPECT_GE(by_name.bucket_count(), 100U);
+  auto range = by_name.equal_range("n7");
+  int sum = 0;
+  for (auto it = range.first; it != range.second; ++it) sum += it->id;
+  EXPECT_EQ(sum, 7 * 10 + 450);
+  EXPECT_EQ(by_name.find("n1")->name, "n1");
+}
+
+TEST(multi_index_mod, erase_00) {
+  records r{{1, 10, "a"}, {2, 10, "a"}, {3, 10, "b"}};
+  r.erase(*r.get<2>().find("b"));
+  EXPECT_EQ(r.size(), 2U);
+  EXPECT_EQ(r.get<0>().contains(3), false);
+  r.erase(*r.get<0>().find(2));
+  EXPECT_EQ(r.get<1>().count(10), 1U);
+  EXPECT_EQ(r.get<2>().count("a"), 1U);
+  EXPECT_EQ(r.get<1>().find(10)->id, 1);
+  EXPECT_EQ(r.insert({2, 5, "a"}).second, true);
+  r.clear();
+  EXPECT_EQ(r.empty(), true);
+  EXPECT_EQ(r.get<2>().find("a") == r.get<2>().end(), true);
+}
+
+TEST(multi_index_mod, copy_00) {
+  records r1{{1, 10, "a"}, {2, 20, "b"}};
+  records r2(r1);
+  r1.erase(*r1.get<0>().find(1));
+  EXPECT_EQ(r2.size(), 2U);
+  EXPECT_EQ(r2.get<2>().find("a")->id, 1);
+  records r3(std::move(r2));
+  EXPECT_EQ(r3.get<1>().find(20)->name, "b");
+  r1 = r3;
+  EXPECT_EQ(r1.size(), 2U);
+  r3 = records{{9, 9, "z"}};
+  EXPECT_EQ(r3.get<0>().begin()->id, 9);
+}
+
+namespace {
+struct touchyLess {
+  bool operator()(long a, long b) const {
+    if (a < 0 || b < 0) throw std::runtime_error("bad timestamp");
+    return a < b;
+  }
+};
+
+struct touchyHash {
+  std::size_t operator()(const std::string& name) const {
+    if (name == "boom") throw std::runtime_error("bad name");
+    return std::hash<std::string>()(name);
+  }
+};
+}  // namespace
+
+TEST(multi_index_mod, rollback_00) {
+  s21::multi_index<Record, s21::ordered_unique<&Record::id>,
+                   s21::ordered_non_unique<&Record::timestamp, touchyLess>,
+                   s21::hashed_non_unique<&Record::name, touchyHash>>
+      r{{1, 10, "a"}, {2, 20, "b"}};
+  EXPECT_THROW(r.insert({3, -1, "c"}), std::runtime_error);
+  EXPECT_THROW(r.insert({4, 40, "boom"}), std::runtime_error);
+  EXPECT_EQ(r.size(), 2U);
+  EXPECT_EQ(r.get<0>().size(), 2U);
+  EXPECT_EQ(r.get<0>().contains(3), false);
+  EXPECT_EQ(r.get<0>().contains(4), false);
+  EXPECT_EQ(r.get<1>().size(), 2U);
+  EXPECT_EQ(r.get<1>().contains(40), false);
+  EXPECT_EQ(r.get<2>().size(), 2U);
+  EXPECT_EQ(r.insert({4, 40, "d"}).second, true);
+  EXPECT_EQ(r.get<2>().find("d")->id, 4);
+}
+
+namespace {
+// Counts live instances; the copy numbered failAt throws.
+struct fragileRecord {
+  static int live;
+  static int copies;
+  static int failAt;
+
+  explicit fragileRecord(int id_) : id(id_) { ++live; }
+  fragileRecord(const fragileRecord &other) : id(other.id) {
+    if (++copies == failAt) throw std::runtime_error("copy failed");
+    ++live;
+  }
+  ~fragileRecord() { --live; }
+
+  int id;
+};
+
+int fragileRecord::live = 0;
+int fragileRecord::copies = 0;
+int fragileRecord::failAt = 0;
+}  // namespace
+
+TEST(multi_index_mod, copy_throws_00) {
+  using fragile_index =
+      s21::multi_index<fragileRecord, s21::ordered_unique<&fragileRecord::id>,
+                       s21::hashed_unique<&fragileRecord::id>>;
+  {
+    fragile_index r;
+    for (int id = 0; id < 10; ++id) r.emplace(id);
+    EXPECT_EQ(fragileRecord::live, 10);
+    fragileRecord::copies = 0;
+    fragileRecord::failAt = 6;
+    EXPECT_THROW(fragile_index copy(r), std::runtime_error);
+    EXPECT_EQ(fragileRecord::live, 10);
+    fragileRecord::failAt = 0;
+    fragile_index copy(r);
+    EXPECT_EQ(copy.size(), 10U);
+    EXPECT_EQ(fragileRecord::live, 20);
+  }
+  EXPECT_EQ(fragileRecord::live, 0);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "s21_multimap.h"
+
+TEST(multimap_capacity, empty_00) {
+  s21::multimap<int, int> m1;
+  ASSERT_EQ(m1.empty(), true);
+  ASSERT_EQ(m1.size(), 0U);
+  ASSERT_EQ(m1.begin() == m1.end(), true);
+  ASSERT_EQ(m1.count(1), 0U);
+}
+
+TEST(multimap_mod, insert_00) {
+  s21::multimap<int, std::string> m1{{2, "b"}, {1, "a"}, {2, "c"}};
+  EXPECT_EQ(m1.size(), 3U);
+  EXPECT_EQ(m1.key_count(), 2U);
+  auto it = m1.insert(2, "d");
+  EXPECT_EQ(it->first, 2);
+  EXPECT_EQ(it->second, "d");
+  EXPECT_EQ(m1.count(2), 3U);
+  EXPECT_EQ(m1.count(1), 1U);
+  EXPECT_EQ(m1.contains(3), false);
+}
+
+TEST(multimap_lookup, equal_range_00) {
+  s21::multimap<int, int> m1;
+  for (int i = 0; i < 10; ++i) m1.insert(i % 3, i);
+  auto range = m1.equal_range(1);
+  std::vector<int> values;
+  for (auto it = range.first; it != range.second; ++it) {
+    EXPECT_EQ((*it).first, 1);
+    values.push_back((*it).second);
+  }
+  EXPECT_EQ(values, (std::vector<int>{1, 4, 7}));
+  range = m1.equal_range(5);
+  EXPECT_EQ(range.first == range.second, true);
+  EXPECT_EQ(m1.find(2)->second, 2);
+  EXPECT_EQ(m1.lower_bound(1)->second, 1);
+  EXPECT_EQ(m1.upper_bound(1)->second, 2);
+  EXPECT_EQ(m1.values(0)->size(), 4U);
+  EXPECT_EQ(m1.values(0)->inlined(), false);
+  EXPECT_EQ(m1.values(7), nullptr);
+}
+
+TEST(multimap_iter, iterators_00) {
+  s21::multimap<int, int> m1{{3, 30}, {1, 10}, {3, 31}, {2, 20}};
+  std::vector<std::pair<int, int>> forward;
+  for (auto it = m1.begin(); it != m1.end(); ++it) {
+    forward.emplace_back(it->first, it->second);
+    it->second += 1;
+  }
+  EXPECT_EQ(forward, (std::vector<std::pair<int, int>>{
+                         {1, 10}, {2, 20}, {3, 30}, {3, 31}}));
+  auto it = m1.end();
+  --it;
+  EXPECT_EQ(it->second, 32);
+  --it;
+  EXPECT_EQ(it->second, 31);
+  --it;
+  EXPECT_EQ(it->second, 21);
+}
+
+TEST(multimap_mod, erase_00) {
+  s21::multimap<int, int> m1{{1, 10}, {1, 11}, {1, 12}, {2, 20}};
+  EXPECT_EQ(m1.erase(2), 1U);
+  EXPECT_EQ(m1.erase(2), 0U);
+  auto it = m1.find(1);
+  ++it;
+  m1.erase(it);
+  EXPECT_EQ(m1.size(), 2U);
+  EXPECT_EQ(m1.begin()->second, 10);
+  EXPECT_EQ((++m1.begin())->second, 12);
+  m1.erase(m1.begin());
+  m1.erase(m1.begin());
+  EXPECT_EQ(m1.empty(), true);
+  EXPECT_EQ(m1.contains(1), false);
+}
+
+TEST(multimap_mod, insert_alias_00) {
+  s21::multimap<int, std::string> m1;
+  std::string first(40, 'a');
+  m1.insert(1, first);
+  m1.insert(1, std::string(40, 'b'));
+  // Each insert copies a value of the same group, which may have to grow.
+  for (int i = 0; i < 6; ++i) m1.insert(1, (*m1.find(1)).second);
+  EXPECT_EQ(m1.count(1), 8U);
+  auto range = m1.equal_range(1);
+  std::vector<std::string> values;
+  for (auto it = range.first; it != range.second; ++it) {
+    values.push_back(it->second);
+  }
+  EXPECT_EQ(values[1], std::string(40, 'b'));
+  values.erase(values.begin() + 1);
+  for (const std::string &value : values) EXPECT_EQ(value, first);
+}
+
+TEST(multimap_mod, copy_merge_00) {
+  s21::multimap<std::string, int> m1{{"a", 1}, {"b", 2}, {"a", 3}};
+  s21::multimap<std::string, int> m2(m1);
+  s21::multimap<std::string, int> m3{{"a", 4}, {"c", 5}};
+  m2.merge(m3);
+  EXPECT_EQ(m3.empty(), true);
+  EXPECT_EQ(m1.size(), 3U);
+  EXPECT_EQ(m2.size(), 5U);
+  EXPECT_EQ(m2.count("a"), 3U);
+  s21::multimap<std::string, int> m4(std::move(m2));
+  EXPECT_EQ(m2.size(), 0U);
+  EXPECT_EQ(m4.count("c"), 1U);
+  m4.swap(m1);
+  EXPECT_EQ(m1.size(), 5U);
+  m1.clear();
+  EXPECT_EQ(m1.begin() == m1.end(), true);
+  s21::multimap<std::string, int>& alias = m4;
+  m4 = std::move(alias);
+  EXPECT_EQ(m4.size(), 3U);
+  m1 = std::move(m4);
+  EXPECT_EQ(m1.count("a"), 2U);
+  EXPECT_EQ(m4.empty(), true);
+}
+
+TEST(multimap_mod, matches_std_00) {
+  s21::multimap<int, int> m1;
+  std::multimap<int, int> expected;
+  unsigned seed = 7;
+  for (int i = 0; i < 2000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    int key = (seed >> 16) % 97;
+    if (i % 5 == 4) {
+      EXPECT_EQ(m1.erase(key), expected.erase(key));
+    } else {
+      m1.insert(key, i);
+      expected.insert({key, i});
+    }
+  }
+  ASSERT_EQ(m1.size(), expected.size());
+  auto std_it = expected.begin();
+  for (auto it = m1.begin(); it != m1.end(); ++it, ++std_it) {
+    EXPECT_EQ(it->first, std_it->first);
+    EXPECT_EQ(it->second, std_it->second);
+  }
+  for (int key = 0; key < 97; ++key) {
+    EXPECT_EQ(m1.count(key), expected.count(key));
+  }
+}
@@ -48,6 +48,17 @@ TEST(multiset_mod, insert_00) {
   ASSERT_EQ((*it), 35);
 }
 
+TEST(multiset_mod, move_00) {
+  s21::multiset<int> ms1({1, 1, 2});
+  s21::multiset<int>& alias = ms1;
+  ms1 = std::move(alias);
+  ASSERT_EQ(ms1.size(), 3U);
+  s21::multiset<int> ms2({5});
+  ms2 = std::move(ms1);
+  ASSERT_EQ(ms2.size(), 3U);
+  ASSERT_EQ(ms1.empty(), true);
+}
+
 TEST(multiset_mod, merge_00) {
   s21::multiset<int> ms1({3, 5, 6, 7});
   s21::multiset<int> ms2({14, 21});
@@ -109,4 +120,36 @@ TEST(multiset_mod, insert_02) {
   EXPECT_EQ(ms1.contains(5), true);
   EXPECT_EQ(ms1.contains(6), true);
   EXPECT_EQ(ms1.contains(99), true);
-}
\ No newline at end of file
+}
+TEST(multiset_access, count_01) {
+  s21::multiset<std::string> ms{"long_common_key_1", "long_common_key_2",
+                                "long_common_key_1", "short",
+                                "long_common_key_1"};
+  EXPECT_EQ(ms.count("long_common_key_1"), 3);
+  EXPECT_EQ(ms.count("long_common_key_2"), 1);
+  EXPECT_EQ(ms.count("long_common_key_3"), 0);
+  EXPECT_EQ(*ms.lower_bound("long_common_key_2"), "long_common_key_2");
+  EXPECT_EQ(*ms.upper_bound("long_common_key_2"), "short");
+}
+
+TEST(multiset_compare, stateful_00) {
+  struct ModuloLess {
+    int modulo;
+    bool operator()(int a, int b) const { return a % modulo < b % modulo; }
+  };
+  s21::multiset<int, ModuloLess> ms(ModuloLess{10});
+  ms.insert_many(21, 3, 11, 15, 1);
+  EXPECT_EQ(ms.count(31), 3);
+  EXPECT_EQ(*ms.begin() % 10, 1);
+  s21::multiset<int, ModuloLess> copy(ms);
+  EXPECT_EQ(copy.key_comp().modulo, 10);
+  EXPECT_EQ(*copy.upper_bound(1), 3);
+}
+
+TEST(multiset_access, find_01) {
+  s21::multiset<int> ms{1, 3, 3};
+  EXPECT_EQ(ms.find(2) == ms.end(), true);
+  EXPECT_EQ(*ms.try_get(3), 3);
+  EXPECT_EQ(ms.try_get(4), nullptr);
+  EXPECT_EQ(ms.get_or(9, 0), 0);
+}
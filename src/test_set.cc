@@ -1,8 +1,12 @@
 #include <gtest/gtest.h>
 
 #include <ostream>
+#include "s21_map.h"
+#include "s21_multiset.h"
 #include "s21_set.h"
+#include <cmath>
 #include <set>
+
 TEST(set_capacity, empty_set_00) {
   s21::set<int> s;
   ASSERT_EQ(s.empty(), true);
@@ -115,4 +119,508 @@ TEST(set_mod, insert_02) {
   EXPECT_EQ(s1.contains(5), true);
   EXPECT_EQ(s1.contains(6), true);
   EXPECT_EQ(s1.contains(99), true);
-}
\ No newline at end of file
+}
+TEST(set_access, string_keys_00) {
+  s21::set<std::string> s1{"prefix_shared_b", "prefix_shared_a", "prefix",
+                           "prefix_s", std::string("pre\0x", 5), "z", ""};
+  std::set<std::string> s2{"prefix_shared_b", "prefix_shared_a", "prefix",
+                           "prefix_s", std::string("pre\0x", 5), "z", ""};
+  auto it = s1.begin();
+  for (const auto& value : s2) {
+    EXPECT_EQ(*it, value);
+    EXPECT_EQ(s1.contains(value), true);
+    ++it;
+  }
+  EXPECT_EQ(s1.contains("prefix_shared_c"), false);
+  EXPECT_EQ(s1.contains(std::string("pre\0", 4)), false);
+}
+
+TEST(set_compare, custom_00) {
+  s21::set<int, std::greater<int>> s1{1, 8, 3, 5};
+  std::set<int, std::greater<int>> s2{1, 8, 3, 5};
+  auto it = s1.begin();
+  for (auto value : s2) {
+    EXPECT_EQ(*it, value);
+    ++it;
+  }
+  EXPECT_EQ(s1.contains(3), true);
+  EXPECT_EQ(*s1.find(5), 5);
+  EXPECT_EQ(s1.key_comp()(8, 1), true);
+}
+
+TEST(set_compare, stateless_size_00) {
+  using tree_type = s21::set<int, std::greater<int>>::tree_type;
+  std::size_t counters = s21::kTreeStats ? sizeof(s21::tree_counters) : 0;
+  EXPECT_EQ(sizeof(tree_type),
+            2 * sizeof(void*) + sizeof(std::size_t) + counters);
+}
+
+TEST(set_compare, transparent_00) {
+  s21::set<std::string, std::less<>> s1{"alpha", "beta", "gamma"};
+  EXPECT_EQ(s1.contains("beta"), true);
+  EXPECT_EQ(s1.contains(std::string_view("gamma")), true);
+  EXPECT_EQ(s1.contains("delta"), false);
+  EXPECT_EQ(*s1.find("alpha"), "alpha");
+}
+
+TEST(set_bloom, negative_lookups_00) {
+  s21::set<int> s1;
+  for (int i = 0; i < 1000; i += 2) s1.insert(i);
+  s1.enable_bloom_filter(0.01);
+  for (int i = 0; i < 1000; i += 2) EXPECT_EQ(s1.contains(i), true);
+  for (int i = 1; i < 1000; i += 2) EXPECT_EQ(s1.contains(i), false);
+  EXPECT_EQ(s1.find(1) == s1.end(), true);
+  auto stats = s1.bloom_filter_stats();
+  EXPECT_EQ(stats.lookups, 1001);
+  EXPECT_GT(stats.filtered, 450);
+  EXPECT_EQ(stats.filtered + stats.false_positives, 501);
+}
+
+TEST(set_bloom, maintenance_00) {
+  s21::set<int> s1{1, 2, 3};
+  s1.enable_bloom_filter();
+  for (int i = 10; i < 5000; ++i) s1.insert(i);
+  for (int i = 10; i < 5000; ++i) ASSERT_EQ(s1.contains(i), true);
+  s1.erase(s1.find(2));
+  EXPECT_EQ(s1.contains(2), false);
+  s1.rebuild_bloom_filter();
+  EXPECT_EQ(s1.contains(3), true);
+  s21::set<int> s2(s1);
+  EXPECT_EQ(s2.bloom_filter_enabled(), true);
+  EXPECT_EQ(s2.contains(4999), true);
+  s1.clear();
+  EXPECT_EQ(s1.contains(3), false);
+  s1.disable_bloom_filter();
+  EXPECT_EQ(s1.bloom_filter_stats().lookups, 0);
+}
+
+template <typename Node>
+int checkHeight(const Node* node) {
+  if (node == nullptr) return 0;
+  if (node->left) {
+    EXPECT_EQ(node->left->parent, node);
+  }
+  if (node->right) {
+    EXPECT_EQ(node->right->parent, node);
+  }
+  int left = checkHeight(node->left), right = checkHeight(node->right);
+  return 1 + std::max(left, right);
+}
+
+template <typename Balance>
+void checkBalancedChurn() {
+  s21::set<int, std::less<int>, Balance> s1;
+  std::set<int> s2;
+  unsigned seed = 12345;
+  for (int step = 0; step < 4000; ++step) {
+    seed = seed * 1103515245u + 12345u;
+    int value = int((seed >> 8) % 500);
+    if (step % 3 == 2 && s1.contains(value)) {
+      s1.erase(s1.find(value));
+      s2.erase(value);
+    } else {
+      s1.insert(value);
+      s2.insert(value);
+    }
+  }
+  ASSERT_EQ(s1.size(), s2.size());
+  auto it = s1.begin();
+  for (auto value : s2) {
+    ASSERT_EQ(*it, value);
+    ++it;
+  }
+  int height = checkHeight(s1.begin().root);
+  EXPECT_LE(height, 2 * int(std::log2(s2.size() + 1)) + 2);
+}
+
+TEST(set_balance, avl_00) { checkBalancedChurn<s21::avl_balance>(); }
+
+TEST(set_balance, red_black_00) {
+  checkBalancedChurn<s21::red_black_balance>();
+}
+
+TEST(set_balance, weight_00) { checkBalancedChurn<s21::weight_balance>(); }
+
+TEST(set_balance, erase_all_00) {
+  s21::set<int, std::less<int>, s21::red_black_balance> s1{5, 3, 8, 1, 4};
+  while (!s1.empty()) s1.erase(s1.begin());
+  s1.insert(7);
+  EXPECT_EQ(*s1.begin(), 7);
+}
+
+TEST(set_access, find_01) {
+  s21::set<int> s1{1, 2, 3};
+  EXPECT_EQ(s1.find(4) == s1.end(), true);
+  EXPECT_EQ(*s1.try_get(2), 2);
+  EXPECT_EQ(s1.try_get(5), nullptr);
+  EXPECT_EQ(s1.get_or(3, -1), 3);
+  EXPECT_EQ(s1.get_or(7, -1), -1);
+}
+
+template <typename Balance>
+void checkBatches() {
+  s21::set<int, std::less<int>, Balance> s1;
+  std::set<int> s2;
+  unsigned seed = 777;
+  for (int round = 0; round < 30; ++round) {
+    std::vector<s21::batch_update<int>> updates;
+    int batch = (round % 3 == 0) ? 400 : 5;
+    for (int i = 0; i < batch; ++i) {
+      seed = seed * 1103515245u + 12345u;
+      int value = int((seed >> 8) % 1000);
+      bool isErase = (seed >> 4) % 3 == 0;
+      updates.push_back(
+          {isErase ? s21::batch_op::erase : s21::batch_op::insert, value});
+      if (isErase) {
+        s2.erase(value);
+      } else {
+        s2.insert(value);
+      }
+    }
+    s1.apply_batch(updates);
+    s1.insert(round);
+    s2.insert(round);
+    ASSERT_EQ(s1.size(), s2.size());
+  }
+  auto it = s1.begin();
+  for (auto value : s2) {
+    ASSERT_EQ(*it, value);
+    ++it;
+  }
+  int height = checkHeight(s1.begin().root);
+  EXPECT_LE(height, 2 * int(std::log2(s2.size() + 1)) + 2);
+}
+
+TEST(set_batch, apply_00) { checkBatches<s21::avl_balance>(); }
+
+TEST(set_batch, apply_01) { checkBatches<s21::red_black_balance>(); }
+
+TEST(set_batch, apply_02) { checkBatches<s21::weight_balance>(); }
+
+TEST(set_batch, apply_03) {
+  s21::set<int> s1{1, 2, 3};
+  s1.enable_bloom_filter();
+  s1.apply_batch({{s21::batch_op::erase, 1},
+                  {s21::batch_op::insert, 9},
+                  {s21::batch_op::erase, 9},
+                  {s21::batch_op::erase, 2},
+                  {s21::batch_op::erase, 3}});
+  EXPECT_EQ(s1.empty(), true);
+  s1.apply_batch({{s21::batch_op::insert, 4}});
+  EXPECT_EQ(s1.contains(4), true);
+  EXPECT_EQ(s1.size(), 1U);
+}
+
+TEST(set_batch, erase_if_00) {
+  s21::set<int, std::less<int>, s21::red_black_balance> s1;
+  for (int i = 0; i < 1000; ++i) s1.insert(i);
+  EXPECT_EQ(s1.erase_if([](int value) { return value % 3 != 0; }), 666U);
+  EXPECT_EQ(s1.size(), 334U);
+  EXPECT_EQ(s1.contains(3), true);
+  EXPECT_EQ(s1.contains(4), false);
+  for (int i = 1000; i < 1100; ++i) s1.insert(i);
+  EXPECT_EQ(s1.erase_if([](int) { return false; }), 0U);
+  EXPECT_EQ(s1.erase_if([](int) { return true; }), 434U);
+  EXPECT_EQ(s1.empty(), true);
+}
+
+TEST(set_compact, in_order_00) {
+  s21::set<int> s1;
+  for (int i = 0; i < 500; ++i) s1.insert((i * 37) % 500);
+  s1.compact();
+  using Node = s21::set<int>::Node;
+  const Node* previous = nullptr;
+  int expected = 0;
+  for (auto it = s1.begin(); it != s1.end(); ++it, ++expected) {
+    ASSERT_EQ(*it, expected);
+    if (previous != nullptr) {
+      ASSERT_EQ(it.iter, previous + 1);
+    }
+    previous = it.iter;
+  }
+  for (int i = 0; i < 500; i += 2) s1.erase(s1.find(i));
+  s1.insert(1000);
+  EXPECT_EQ(s1.size(), 251U);
+  EXPECT_EQ(s1.contains(499), true);
+  EXPECT_EQ(s1.contains(498), false);
+  s1.clear();
+  EXPECT_EQ(s1.empty(), true);
+}
+
+TEST(set_compact, van_emde_boas_00) {
+  s21::set<int, std::less<int>, s21::red_black_balance> s1;
+  for (int i = 0; i < 1000; ++i) s1.insert(i);
+  s1.compact(s21::node_layout::van_emde_boas);
+  auto* root = s1.begin().root;
+  EXPECT_EQ(root->left, root + 1);
+  int expected = 0;
+  for (auto value : s1) ASSERT_EQ(value, expected++);
+  EXPECT_EQ(expected, 1000);
+  s1.compact(s21::node_layout::van_emde_boas);
+  for (int i = 0; i < 1000; i += 3) s1.erase(s1.find(i));
+  EXPECT_EQ(s1.size(), 666U);
+  int height = checkHeight(s1.begin().root);
+  EXPECT_LE(height, 2 * int(std::log2(s1.size() + 1)) + 2);
+}
+
+TEST(set_compact, incremental_00) {
+  s21::set<int> s1;
+  for (int i = 0; i < 300; ++i) s1.insert(i * 2);
+  s1.begin_compact();
+  int steps = 0;
+  while (!s1.compact_step(16)) {
+    s1.insert(steps * 2 + 1);
+    ++steps;
+  }
+  EXPECT_EQ(steps, 18);
+  EXPECT_EQ(s1.size(), 318U);
+  s1.begin_compact(s21::node_layout::van_emde_boas);
+  EXPECT_EQ(s1.compact_step(10), false);
+  s1.erase(s1.find(0));
+  EXPECT_EQ(s1.compact_step(10), true);
+  int count = 0;
+  for (auto it = s1.begin(); it != s1.end(); ++it) ++count;
+  EXPECT_EQ(count, 317);
+  s21::set<int> s2(std::move(s1));
+  EXPECT_EQ(s2.contains(598), true);
+}
+
+TEST(set_compact, release_00) {
+  s21::set<int> s1;
+  for (int round = 0; round < 4; ++round) {
+    for (int i = 0; i < 200; ++i) s1.insert(round * 1000 + i);
+    s1.begin_compact(round % 2 == 0 ? s21::node_layout::in_order
+                                    : s21::node_layout::van_emde_boas);
+    s1.compact_step(300);
+  }
+  EXPECT_EQ(s1.size(), 800U);
+  for (int round = 0; round < 4; ++round) {
+    for (int i = 0; i < 200; i += 2) s1.erase(s1.find(round * 1000 + i));
+  }
+  EXPECT_EQ(s1.size(), 400U);
+  EXPECT_EQ(s1.erase_if([](int value) { return value < 2000; }), 200U);
+  s1.compact();
+  s1.clear();
+  for (int i = 0; i < 100; ++i) s1.insert(i);
+  s21::set<int> s2(s1);
+  s2.compact();
+  s1 = std::move(s2);
+  EXPECT_EQ(s1.size(), 100U);
+  EXPECT_EQ(*s1.begin(), 0);
+}
+
+TEST(set_balance, threaded_00) {
+  checkBalancedChurn<s21::threaded<s21::avl_balance>>();
+  checkBalancedChurn<s21::threaded<s21::red_black_balance>>();
+}
+
+TEST(set_iter, threaded_00) {
+  using threaded_set = s21::set<int, std::less<int>,
+                                s21::threaded<s21::weight_balance>>;
+  threaded_set s1;
+  for (int i = 0; i < 200; ++i) s1.insert((i * 7) % 200);
+  for (int i = 0; i < 200; i += 4) s1.erase(s1.find(i));
+  s1.erase_if([](int value) { return value % 5 == 0; });
+  s1.apply_batch({{s21::batch_op::insert, 500}, {s21::batch_op::erase, 1}});
+  s1.compact(s21::node_layout::van_emde_boas);
+  threaded_set s2(s1);
+  std::set<int> expected;
+  for (int i = 0; i < 200; ++i) {
+    if (i % 4 != 0 && i % 5 != 0 && i != 1) expected.insert(i);
+  }
+  expected.insert(500);
+  ASSERT_EQ(s2.size(), expected.size());
+  auto it = s2.end();
+  for (auto value = expected.rbegin(); value != expected.rend(); ++value) {
+    --it;
+    ASSERT_EQ(*it, *value);
+  }
+  EXPECT_EQ(it == s2.begin(), true);
+  std::vector<int> scanned;
+  s2.for_each_in_range(10, 30, [&](int value) { scanned.push_back(value); });
+  std::vector<int> range(expected.lower_bound(10), expected.lower_bound(30));
+  EXPECT_EQ(scanned, range);
+}
+
+TEST(set_iter, for_each_in_range_00) {
+  s21::set<int> s1{1, 3, 5, 7, 9};
+  int sum = 0;
+  s1.for_each_in_range(3, 9, [&](int value) { sum += value; });
+  EXPECT_EQ(sum, 15);
+  s1.for_each_in_range(9, 3, [&](int value) { sum += value; });
+  s1.for_each_in_range(10, 20, [&](int value) { sum += value; });
+  EXPECT_EQ(sum, 15);
+  auto it = s1.end();
+  EXPECT_EQ(*--it, 9);
+}
+
+TEST(set_copy, large_00) {
+  s21::set<int, std::less<int>, s21::threaded<s21::avl_balance>> s1;
+  for (int i = 0; i < 100000; ++i) s1.insert(i);
+  auto s2 = s1;
+  ASSERT_EQ(s2.size(), 100000U);
+  checkHeight(s2.begin().root);
+  int expected = 0;
+  for (auto value : s2) ASSERT_EQ(value, expected++);
+  auto it = s2.end();
+  EXPECT_EQ(*--it, 99999);
+  s1.clear();
+  EXPECT_EQ(s1.empty(), true);
+  EXPECT_EQ(s2.contains(4242), true);
+}
+
+TEST(set_copy, background_reclaim_00) {
+  auto* s1 = new s21::set<std::string>;
+  s1->set_background_reclaim(true);
+  EXPECT_EQ(s1->background_reclaim(), true);
+  for (int i = 0; i < 70000; ++i) s1->insert(std::to_string(i));
+  s21::set<std::string> s2(*s1);
+  s1->clear();
+  EXPECT_EQ(s1->empty(), true);
+  s1->insert("again");
+  delete s1;
+  s21::Reclaimer::instance().drain();
+  EXPECT_EQ(s2.size(), 70000U);
+  EXPECT_EQ(s2.contains("69999"), true);
+}
+
+TEST(set_stats, shape_00) {
+  s21::set<int> s1{4, 2, 6, 1, 3, 5, 7};
+  s21::tree_stats stats = s1.stats();
+  EXPECT_EQ(stats.size, 7U);
+  EXPECT_EQ(stats.height, 3U);
+  EXPECT_DOUBLE_EQ(stats.average_depth, 17.0 / 7.0);
+  EXPECT_EQ(stats.balance_histogram.size(), 1U);
+  EXPECT_EQ(stats.balance_histogram[0], 7U);
+  EXPECT_EQ(stats.node_bytes, sizeof(s21::set<int>::Node));
+  EXPECT_GT(stats.bytes_per_element, double(stats.node_bytes));
+  s1.insert(8);
+  s1.insert(9);
+  stats = s1.stats();
+  EXPECT_EQ(stats.height, 4U);
+  EXPECT_EQ(stats.balance_histogram[1], 2U);
+  EXPECT_EQ(s21::set<int>().stats().height, 0U);
+}
+
+TEST(set_stats, counters_00) {
+  s21::set<int, std::less<int>, s21::red_black_balance> s1;
+  for (int i = 0; i < 100; ++i) s1.insert(i);
+  s1.erase(s1.find(50));
+  s21::tree_counters counters = s1.stats().counters;
+#ifdef S21_CONTAINERS_STATS
+  EXPECT_EQ(counters.allocations, 100U);
+  EXPECT_EQ(counters.deallocations, 1U);
+  EXPECT_GT(counters.comparisons, 100U);
+  EXPECT_GT(counters.rotations, 0U);
+  EXPECT_GT(counters.rebalance_steps, 0U);
+  s1.reset_counters();
+  EXPECT_EQ(s1.stats().counters.rotations, 0U);
+#else
+  EXPECT_EQ(counters.comparisons, 0U);
+  EXPECT_EQ(counters.rotations, 0U);
+  using tree_type = s21::set<int>::tree_type;
+  EXPECT_EQ(sizeof(tree_type), 2 * sizeof(void*) + sizeof(std::size_t));
+#endif
+}
+
+TEST(set_txn, rollback_00) {
+  s21::set<int> s1{1, 2, 3};
+  s1.begin_txn();
+  s1.insert(4);
+  s1.erase(s1.find(2));
+  auto mark = s1.savepoint();
+  s1.clear();
+  s1.insert(9);
+  s1.rollback(mark);
+  EXPECT_EQ(s1.size(), 3U);
+  EXPECT_EQ(s1.contains(4), true);
+  EXPECT_EQ(s1.contains(9), false);
+  s1.apply_batch({{s21::batch_op::erase, 1}, {s21::batch_op::insert, 5}});
+  s1.erase_if([](int value) { return value > 3; });
+  EXPECT_EQ(s1.size(), 1U);
+  s1.rollback();
+  EXPECT_EQ(s1.size(), 3U);
+  EXPECT_EQ(s1.contains(2), true);
+  EXPECT_EQ(s1.contains(4), false);
+  EXPECT_EQ(s1.contains(5), false);
+  s1.begin_txn();
+  s1.insert(6);
+  s1.commit();
+  EXPECT_EQ(s1.contains(6), true);
+}
+
+TEST(set_txn, move_00) {
+  s21::set<int> s1{1, 2, 3};
+  s21::set<int> s2{7};
+  s21::set<int>& alias = s1;
+  s1 = std::move(alias);
+  EXPECT_EQ(s1.size(), 3U);
+  s1.begin_txn();
+  s2.begin_txn();
+  s2 = std::move(s1);
+  EXPECT_EQ(s1.empty(), true);
+  EXPECT_EQ(s2.size(), 3U);
+  s1.rollback();
+  s2.rollback();
+  EXPECT_EQ(s1.size(), 3U);
+  EXPECT_EQ(s2.size(), 1U);
+  EXPECT_EQ(s2.contains(7), true);
+}
+
+namespace {
+// Element that counts its live instances. Every tree node holds one, so
+// the count tells how many nodes the containers of a test own without
+// hooking the allocator of the whole test binary.
+struct tracked {
+  static int live;
+
+  tracked(int v = 0) : value(v) { ++live; }
+  tracked(const tracked &other) : value(other.value) { ++live; }
+  tracked &operator=(const tracked &) = default;
+  ~tracked() { --live; }
+
+  bool operator<(const tracked &other) const { return value < other.value; }
+
+  int value;
+};
+
+int tracked::live = 0;
+}  // namespace
+
+TEST(set_alloc, empty_00) {
+  {
+    s21::set<tracked> s1;
+    s21::set<tracked> s2(std::move(s1));
+    s21::set<tracked> s3(s1);
+    s2.clear();
+    s2.swap(s3);
+    EXPECT_TRUE(s2.empty());
+    EXPECT_TRUE(s2.begin() == s2.end());
+    EXPECT_FALSE(s2.contains(1));
+    s21::map<tracked, tracked> m1;
+    s21::map<tracked, tracked> m2(std::move(m1));
+    m2.clear();
+    s21::multiset<tracked> ms1;
+    s21::multiset<tracked> ms2(std::move(ms1));
+    ms2.clear();
+    EXPECT_EQ(tracked::live, 0);
+  }
+  EXPECT_EQ(tracked::live, 0);
+}
+
+TEST(set_alloc, reuse_00) {
+  s21::set<tracked> s1{1, 2, 3};
+  s21::set<tracked> s2(std::move(s1));
+  EXPECT_TRUE(s1.empty());
+  s1.insert(4);
+  EXPECT_EQ((*s1.begin()).value, 4);
+  s2.clear();
+  EXPECT_EQ(tracked::live, 1);
+  s2.insert(5);
+  EXPECT_EQ(tracked::live, 2);
+  EXPECT_EQ(s2.stats().counters.allocations, s21::kTreeStats ? 1U : 0U);
+  s2.erase(s2.begin());
+  EXPECT_TRUE(s2.begin() == s2.end());
+  s2.insert(6);
+  EXPECT_EQ((*s2.begin()).value, 6);
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <map>
+#include <string>
+
+#include "s21_split_map.h"
+
+TEST(split_map_capacity, empty_00) {
+  s21::split_map<int, int> m1;
+  ASSERT_EQ(m1.empty(), true);
+  ASSERT_EQ(m1.size(), 0U);
+  ASSERT_EQ(m1.begin() == m1.end(), true);
+}
+
+TEST(split_map_mod, insert_00) {
+  s21::split_map<int, std::string> m1{{2, "two"}, {1, "one"}, {3, "three"}};
+  EXPECT_EQ(m1.size(), 3U);
+  auto result = m1.insert(2, "TWO");
+  EXPECT_EQ(result.second, false);
+  EXPECT_EQ((*result.first).second, "two");
+  result = m1.insert_or_assign(2, "TWO");
+  EXPECT_EQ(m1.at(2), "TWO");
+  EXPECT_EQ(m1.try_emplace(4, 2, '4').second, true);
+  EXPECT_EQ(m1.at(4), "44");
+  m1[5] = "five";
+  EXPECT_EQ(m1.get_or(5, ""), "five");
+  EXPECT_EQ(m1.try_get(6), nullptr);
+  EXPECT_THROW(m1.at(6), std::out_of_range);
+}
+
+TEST(split_map_iter, iterators_00) {
+  s21::split_map<int, int> m1{{3, 30}, {1, 10}, {2, 20}};
+  int expected = 1;
+  for (auto it = m1.begin(); it != m1.end(); ++it, ++expected) {
+    EXPECT_EQ(it->first, expected);
+    EXPECT_EQ((*it).second, expected * 10);
+    it->second += 1;
+  }
+  auto it = m1.end();
+  --it;
+  EXPECT_EQ(it->first, 3);
+  --it;
+  EXPECT_EQ((*it).second, 21);
+  s21::split_map<int, int>::const_iterator cit = m1.cbegin();
+  EXPECT_EQ(cit->second, 11);
+}
+
+TEST(split_map_mod, references_00) {
+  using Payload = std::array<long, 64>;
+  s21::split_map<unsigned long, Payload> m1;
+  m1[7].fill(7);
+  Payload* seven = m1.try_get(7);
+  for (unsigned long i = 0; i < 1000; ++i) m1[i + 100].fill(long(i));
+  for (unsigned long i = 0; i < 1000; i += 2) m1.erase(m1.find(i + 100));
+  EXPECT_EQ(seven, m1.try_get(7));
+  EXPECT_EQ((*seven)[63], 7);
+  EXPECT_EQ(m1.size(), 501U);
+  for (unsigned long i = 0; i < 500; ++i) m1[i + 5000].fill(-1);
+  EXPECT_EQ(m1.at(101)[0], 1);
+  EXPECT_EQ(m1.at(5499)[0], -1);
+}
+
+TEST(split_map_mod, copy_00) {
+  s21::split_map<std::string, std::string> m1{{"a", "x"}, {"b", "y"}};
+  s21::split_map<std::string, std::string> m2(m1);
+  m2.at("a") = "z";
+  EXPECT_EQ(m1.at("a"), "x");
+  EXPECT_EQ(m2.at("a"), "z");
+  s21::split_map<std::string, std::string> m3(std::move(m2));
+  EXPECT_EQ(m3.at("b"), "y");
+  m1 = m3;
+  EXPECT_EQ(m1.at("a"), "z");
+  m3.clear();
+  EXPECT_EQ(m3.empty(), true);
+  m3.merge(m1);
+  EXPECT_EQ(m3.size(), 2U);
+  EXPECT_EQ(m1.empty(), true);
+  m1.swap(m3);
+  EXPECT_EQ(m1.at("b"), "y");
+}
+
+TEST(split_map_mod, churn_00) {
+  s21::split_map<int, std::string> m1;
+  std::map<int, std::string> m2;
+  unsigned seed = 99;
+  for (int step = 0; step < 3000; ++step) {
+    seed = seed * 1103515245u + 12345u;
+    int key = int((seed >> 8) % 300);
+    if (step % 3 == 0 && m1.contains(key)) {
+      m1.erase(m1.find(key));
+      m2.erase(key);
+    } else {
+      m1[key] += char('a' + step % 26);
+      m2[key] += char('a' + step % 26);
+    }
+  }
+  ASSERT_EQ(m1.size(), m2.size());
+  auto it = m1.begin();
+  for (const auto& item : m2) {
+    ASSERT_EQ(it->first, item.first);
+    ASSERT_EQ(it->second, item.second);
+    ++it;
+  }
+}
+
+namespace {
+// Copies throw once copiesLeft runs out; live counts the instances.
+struct fragile {
+  static int copiesLeft;
+  static int live;
+
+  fragile() { ++live; }
+  fragile(const fragile&) {
+    if (copiesLeft-- == 0) throw std::runtime_error("copy failed");
+    ++live;
+  }
+  ~fragile() { --live; }
+};
+
+int fragile::copiesLeft = 0;
+int fragile::live = 0;
+}  // namespace
+
+TEST(split_map_mod, copy_throws_00) {
+  {
+    s21::split_map<int, fragile> m1;
+    for (int i = 0; i < 50; ++i) m1.try_emplace(i);
+    EXPECT_EQ(fragile::live, 50);
+    fragile::copiesLeft = 20;
+    using map_type = s21::split_map<int, fragile>;
+    EXPECT_THROW(map_type m2(m1), std::runtime_error);
+    EXPECT_EQ(fragile::live, 50);
+    fragile::copiesLeft = 100;
+    map_type m3(m1);
+    EXPECT_EQ(fragile::live, 100);
+  }
+  EXPECT_EQ(fragile::live, 0);
+}
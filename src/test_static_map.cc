@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "s21_static_map.h"
+
+namespace {
+enum class status { ok = 200, not_found = 404, teapot = 418 };
+
+constexpr s21::static_map<std::string_view, int, 4> commands{
+    {{"get", 1}, {"put", 2}, {"delete", 3}, {"list", 4}}};
+
+constexpr auto reasons = s21::make_static_map<status, std::string_view>(
+    {{status::ok, "OK"},
+     {status::not_found, "Not Found"},
+     {status::teapot, "I'm a teapot"}});
+
+constexpr auto primes = s21::make_static_set<int>({2, 3, 5, 7, 11, 13});
+
+// Evaluated by the compiler: no run-time initialization or lookup.
+static_assert(commands.at("put") == 2);
+static_assert(commands.contains("list"));
+static_assert(!commands.contains("patch"));
+static_assert(reasons.at(status::teapot) == "I'm a teapot");
+static_assert(primes.contains(11) && !primes.contains(9));
+static_assert(primes.size() == 6);
+static_assert(commands.get_or("patch", -1) == -1);
+}  // namespace
+
+TEST(static_map_lookup, find_00) {
+  EXPECT_EQ(commands.at("get"), 1);
+  EXPECT_EQ(commands.at(std::string("delete")), 3);
+  EXPECT_THROW(commands.at("patch"), std::out_of_range);
+  EXPECT_TRUE(commands.find("patch") == commands.end());
+  EXPECT_EQ(commands.find("list")->second, 4);
+  EXPECT_EQ(commands.count("put"), 1U);
+  EXPECT_EQ(commands.get_or("patch", -1), -1);
+  // Returned by value, so the reference extends the lifetime of the copy.
+  const int &fallback = commands.get_or("patch", -1);
+  EXPECT_EQ(fallback, -1);
+  EXPECT_EQ(reasons.at(status::not_found), "Not Found");
+}
+
+TEST(static_map_lookup, order_00) {
+  std::vector<std::string_view> keys;
+  for (const auto &entry : commands) keys.push_back(entry.first);
+  EXPECT_EQ(keys, (std::vector<std::string_view>{"get", "put", "delete",
+                                                 "list"}));
+  EXPECT_EQ(commands.size(), 4U);
+  EXPECT_FALSE(commands.empty());
+}
+
+TEST(static_map_lookup, large_00) {
+  s21::static_entry<int, int> items[500] = {};
+  for (int i = 0; i < 500; ++i) items[i] = {i * 7919, i};
+  s21::static_map<int, int, 500> table(items);
+  for (int i = 0; i < 500; ++i) EXPECT_EQ(table.at(i * 7919), i);
+  for (int i = 1; i < 7919; i += 97) EXPECT_FALSE(table.contains(i));
+}
+
+TEST(static_map_lookup, duplicate_00) {
+  s21::static_entry<std::string_view, int> items[] = {{"a", 1}, {"a", 2}};
+  EXPECT_THROW((s21::static_map<std::string_view, int, 2>(items)),
+               std::invalid_argument);
+}
+
+TEST(static_set_lookup, find_00) {
+  EXPECT_TRUE(primes.contains(13));
+  EXPECT_FALSE(primes.contains(4));
+  EXPECT_EQ(*primes.find(5), 5);
+  int sum = 0;
+  for (int p : primes) sum += p;
+  EXPECT_EQ(sum, 41);
+}